@@ -0,0 +1,553 @@
+/*
+  sl_robot_circular_buffer_core.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_ROBOT_CIRCULAR_BUFFER_CORE_HPP__
+#define __SL_ROBOT_CIRCULAR_BUFFER_CORE_HPP__
+
+#include <Arduino.h>
+#include <cstring>
+
+#include "sl_robot_types.hpp"
+#include "sl_robot_utils.hpp"
+
+namespace sandor_laboratories
+{
+  namespace robot
+  {
+    typedef unsigned int circular_buffer_index_t;
+
+    typedef enum : uint8_t
+    {
+      CIRCULAR_BUFFER_ENTRY_AVAILABLE,
+      CIRCULAR_BUFFER_ENTRY_ALLOCATED,
+      CIRCULAR_BUFFER_ENTRY_COMMITED,
+
+    } circular_buffer_entry_state_e;
+
+    /* Circular buffer storage on the heap, sized at construction.  Mutex is optional */
+    template <typename T>
+    class circular_buffer_heap_storage_c
+    {
+      protected:
+        /* Config Data */
+        const circular_buffer_index_t buffer_size;
+
+        /* Mutex Handle */
+        mutex_handle_t* const mutex;
+
+        /* Buffer - entry states are kept in their own compact array so data entries are naturally aligned */
+        circular_buffer_entry_state_e* entry_state;
+        T*                             circular_buffer;
+
+        circular_buffer_heap_storage_c(circular_buffer_index_t constructor_size, bool mutexed)
+          : buffer_size(constructor_size),
+            mutex(mutexed?((mutex_handle_t*) heap_malloc(sizeof(mutex_handle_t))):nullptr)
+        {
+          if(mutex)
+          {
+            mutex_init(mutex);
+          }
+
+          entry_state     = (circular_buffer_entry_state_e*) heap_malloc(buffer_size*sizeof(circular_buffer_entry_state_e));
+          memset(entry_state, CIRCULAR_BUFFER_ENTRY_AVAILABLE, (buffer_size*sizeof(circular_buffer_entry_state_e)));
+          circular_buffer = (T*) heap_malloc(buffer_size*sizeof(T));
+          memset(circular_buffer, 0, (buffer_size*sizeof(T)));
+        }
+        ~circular_buffer_heap_storage_c()
+        {
+          heap_free((void*)circular_buffer);
+          heap_free((void*)entry_state);
+          if(mutex)
+          {
+            mutex_deinit(mutex);
+            heap_free(mutex);
+          }
+        }
+
+        inline circular_buffer_index_t wrap_index(circular_buffer_index_t index) const {return (index % buffer_size);}
+        inline bool                    has_mutex() const {return (nullptr != mutex);}
+        inline void                    lock()   {if(mutex){mutex_lock(mutex);}}
+        inline void                    unlock() {if(mutex){mutex_unlock(mutex);}}
+    };
+
+    /* Circular buffer storage inline with compile-time capacity, never touches the heap and can be constant initialized.
+        N must be a power of 2 so index wrapping is a constant mask.
+        As mutexes cannot be created before the scheduler, a mutex is only used once init_mutex() is called */
+    template <typename T, circular_buffer_index_t N>
+    class circular_buffer_inline_storage_c
+    {
+      static_assert((N > 0) && (0 == (N & (N-1))), "circular buffer inline storage size must be a power of 2");
+
+      protected:
+        /* Config Data */
+        static constexpr circular_buffer_index_t buffer_size = N;
+
+        /* Mutex Handle */
+        mutex_handle_t mutex;
+
+        /* Buffer - entry states are kept in their own compact array so data entries are naturally aligned */
+        circular_buffer_entry_state_e entry_state[N];
+        T                             circular_buffer[N];
+
+        constexpr circular_buffer_inline_storage_c() : mutex(nullptr), entry_state{}, circular_buffer{} {}
+        ~circular_buffer_inline_storage_c()
+        {
+          if(mutex)
+          {
+            mutex_deinit(&mutex);
+          }
+        }
+
+        static constexpr circular_buffer_index_t wrap_index(circular_buffer_index_t index) {return (index & (N-1));}
+        inline bool                              has_mutex() const {return (nullptr != mutex);}
+        inline void                              lock()   {if(mutex){mutex_lock(&mutex);}}
+        inline void                              unlock() {if(mutex){mutex_unlock(&mutex);}}
+
+      public:
+        /* Creates mutex guarding the buffer.  Call once after the scheduler is available and before concurrent use */
+        void init_mutex()
+        {
+          if(nullptr == mutex)
+          {
+            mutex_init(&mutex);
+          }
+        }
+    };
+
+    /* Circular buffer logic shared by circular_buffer_c (heap storage) and static_circular_buffer_c (inline storage).
+        STORAGE_T provides buffer_size, entry_state, circular_buffer, wrap_index(), and lock()/unlock() */
+    template <typename T, typename STORAGE_T>
+    class circular_buffer_core_c : public STORAGE_T
+    {
+      private:
+        using STORAGE_T::buffer_size;
+        using STORAGE_T::entry_state;
+        using STORAGE_T::circular_buffer;
+        using STORAGE_T::wrap_index;
+        using STORAGE_T::has_mutex;
+        using STORAGE_T::lock;
+        using STORAGE_T::unlock;
+
+        /* Iterators - padded so producer and consumer indices never share a cache line */
+        circular_buffer_index_t read_index;
+        uint8_t                 read_index_pad[SL_ROBOT_CACHE_LINE_SIZE];
+        circular_buffer_index_t write_index;
+        uint8_t                 write_index_pad[SL_ROBOT_CACHE_LINE_SIZE];
+
+        /* Entries evicted by forced pushes, since last cleared and in total */
+        circular_buffer_index_t evicted_count;
+        circular_buffer_index_t evicted_total;
+        /* Set by peeks, with evicted_total at the time, so pops after a peek skip entries evicted since */
+        bool                    peek_outstanding;
+        circular_buffer_index_t peek_evicted_total;
+
+        /* Occupancy for watermark waits */
+        circular_buffer_index_t occupied_count;
+        circular_buffer_index_t commited_count;
+
+        /* Task blocked in wait_available() or wait_space() and the watermark it is waiting for */
+        typedef struct
+        {
+          task_handle_t           task;
+          circular_buffer_index_t watermark;
+        } buffer_waiter_s;
+        buffer_waiter_s available_waiter;
+        buffer_waiter_s space_waiter;
+
+        /* Frees entry at read_index, caller must hold mutex */
+        inline void free_read_entry()
+        {
+          entry_state[read_index] = CIRCULAR_BUFFER_ENTRY_AVAILABLE;
+          read_index = wrap_index(read_index + 1);
+          occupied_count--;
+          commited_count--;
+        }
+        /* Records a peek, caller must hold mutex */
+        inline void mark_peek()
+        {
+          peek_outstanding   = true;
+          peek_evicted_total = evicted_total;
+        }
+        /* Returns entries of the outstanding peek already evicted, up to count, and clears the peek.  Caller must hold mutex */
+        inline circular_buffer_index_t take_peek_evicted(circular_buffer_index_t count)
+        {
+          const circular_buffer_index_t peek_evicted = peek_outstanding ? (evicted_total - peek_evicted_total) : 0;
+          peek_outstanding = false;
+          return (peek_evicted < count) ? peek_evicted : count;
+        }
+        /* Notifies waiters whose watermark has been crossed, caller must hold mutex */
+        void notify_waiters()
+        {
+          if(available_waiter.task && (commited_count >= available_waiter.watermark))
+          {
+            task_notify(available_waiter.task, SL_ROBOT_NOTIFY_INDEX_BUFFER);
+            available_waiter.task = nullptr;
+          }
+          if(space_waiter.task && ((buffer_size - occupied_count) >= space_waiter.watermark))
+          {
+            task_notify(space_waiter.task, SL_ROBOT_NOTIFY_INDEX_BUFFER);
+            space_waiter.task = nullptr;
+          }
+        }
+        /* Blocks until watermark is reached or timeout expires */
+        bool wait_watermark(buffer_waiter_s* waiter, circular_buffer_index_t watermark, time_ms_t timeout)
+        {
+          const time_ms_t start_time = millis();
+          bool            reached    = false;
+
+          /* Waiter registration and notification rely on the mutex */
+          ASSERT(has_mutex());
+          ASSERT((watermark > 0) && (watermark <= buffer_size));
+
+          while(true)
+          {
+            lock();
+            reached = (&available_waiter == waiter) ? (commited_count >= watermark) :
+                                                      ((buffer_size - occupied_count) >= watermark);
+            /* Register before releasing the lock so a crossing between unlock and wait still leaves a pending notification */
+            waiter->task      = reached ? nullptr : task_get_current();
+            waiter->watermark = watermark;
+            unlock();
+
+            const time_ms_t elapsed = (millis() - start_time);
+            if(reached || ((SL_ROBOT_WAIT_FOREVER != timeout) && (elapsed >= timeout)))
+            {
+              break;
+            }
+            task_notify_wait(((SL_ROBOT_WAIT_FOREVER == timeout) ? SL_ROBOT_WAIT_FOREVER : (timeout - elapsed)), SL_ROBOT_NOTIFY_INDEX_BUFFER);
+          }
+
+          if(!reached)
+          {
+            /* Timed out, deregister */
+            lock();
+            waiter->task = nullptr;
+            unlock();
+          }
+
+          return reached;
+        }
+
+        /* Commits entry at index if it matches commit_data, caller must hold mutex */
+        bool commit_index(circular_buffer_index_t index, const T* commit_data)
+        {
+          bool ret_val = false;
+
+          if((index < buffer_size) &&
+             (&circular_buffer[index] == commit_data) &&
+             (CIRCULAR_BUFFER_ENTRY_ALLOCATED == entry_state[index]))
+          {
+            entry_state[index] = CIRCULAR_BUFFER_ENTRY_COMMITED;
+            commited_count++;
+            ret_val = true;
+            notify_waiters();
+          }
+
+          return ret_val;
+        }
+
+      protected:
+        template <typename... STORAGE_ARGS>
+        constexpr circular_buffer_core_c(STORAGE_ARGS... storage_args)
+          : STORAGE_T(storage_args...), read_index(0), read_index_pad{}, write_index(0), write_index_pad{}, evicted_count(0),
+            evicted_total(0), peek_outstanding(false), peek_evicted_total(0), occupied_count(0), commited_count(0), available_waiter{nullptr, 0}, space_waiter{nullptr, 0} {}
+
+      public:
+        /* Reservation handle returned by allocate().  Carries the slot index so commit is constant time,
+            and converts to the entry pointer so existing pointer based callers are unchanged */
+        class handle_c
+        {
+          friend class circular_buffer_core_c;
+
+          private:
+            T*                      data;
+            circular_buffer_index_t index;
+
+            handle_c(T* data, circular_buffer_index_t index) : data(data), index(index) {}
+
+          public:
+            handle_c() : data(nullptr), index(0) {}
+
+            operator T*()   const {return data;}
+            T* operator->() const {return data;}
+        };
+
+        /* Read-only view of contiguous commited entries returned by peek_span() */
+        class span_c
+        {
+          friend class circular_buffer_core_c;
+
+          private:
+            const T*                entries;
+            circular_buffer_index_t count;
+
+          public:
+            span_c() : entries(nullptr), count(0) {}
+
+            circular_buffer_index_t size() const {return count;}
+            const T& operator[](circular_buffer_index_t i) const {return entries[i];}
+        };
+
+        /* Push item into buffer (by copy), returns 'true' if successful.
+            If force is set and the buffer is full, the oldest commited entry is evicted to make room (flight recorder mode).
+            Allocated entries are never evicted.  Pointers from peek_ptr()/peek_span() may be overwritten by forced pushes,
+            and pop_void()/pop_n() after a peek skip peeked entries already evicted so unseen entries are never freed */
+        bool push(const T* input, bool force=false)
+        {
+          bool ret_val = false;
+
+          lock();
+          if((true == force) &&
+             (CIRCULAR_BUFFER_ENTRY_COMMITED == entry_state[write_index]))
+          {
+            /* Buffer is full (write_index has caught read_index), advance read side past oldest entry */
+            ASSERT(write_index == read_index);
+            free_read_entry();
+            evicted_count++;
+            evicted_total++;
+          }
+
+          if(CIRCULAR_BUFFER_ENTRY_AVAILABLE == entry_state[write_index])
+          {
+            circular_buffer[write_index] = *input;
+            entry_state[write_index]     = CIRCULAR_BUFFER_ENTRY_COMMITED;
+            write_index = wrap_index(write_index + 1);
+            occupied_count++;
+            commited_count++;
+            ret_val = true;
+            notify_waiters();
+          }
+          unlock();
+
+          return ret_val;
+        }
+        /* Pushes up to count items into buffer (by copy) with a single lock.  Returns number of items pushed */
+        circular_buffer_index_t push_n(const T* input, circular_buffer_index_t count)
+        {
+          circular_buffer_index_t pushed = 0;
+
+          lock();
+          while((pushed < count) &&
+                (CIRCULAR_BUFFER_ENTRY_AVAILABLE == entry_state[write_index]))
+          {
+            circular_buffer[write_index] = input[pushed];
+            entry_state[write_index]     = CIRCULAR_BUFFER_ENTRY_COMMITED;
+            write_index = wrap_index(write_index + 1);
+            occupied_count++;
+            commited_count++;
+            pushed++;
+          }
+          notify_waiters();
+          unlock();
+
+          return pushed;
+        }
+        /* Returns handle to next available entry or a null handle if no free entries.  Entry remains writable and cannot be read until commited.  */
+        handle_c allocate()
+        {
+          handle_c ret_handle;
+
+          lock();
+          if(CIRCULAR_BUFFER_ENTRY_AVAILABLE == entry_state[write_index])
+          {
+            ret_handle = handle_c(&circular_buffer[write_index], write_index);
+            entry_state[write_index] = CIRCULAR_BUFFER_ENTRY_ALLOCATED;
+            write_index = wrap_index(write_index + 1);
+            occupied_count++;
+          }
+          unlock();
+
+          return ret_handle;
+        }
+        /* Commits allocated entry for reading.  Returns 'true' if successful */
+        bool commit(const handle_c& handle)
+        {
+          bool ret_val;
+
+          lock();
+          ret_val = commit_index(handle.index, handle.data);
+          unlock();
+          ASSERT(ret_val);
+
+          return ret_val;
+        }
+        /* Compatibility shim to commit by entry pointer.  Returns 'true' if successful */
+        bool commit(const T* commit_data)
+        {
+          bool ret_val;
+
+          /* Recover slot index from the entry's offset into the buffer */
+          const circular_buffer_index_t index = (circular_buffer_index_t) (commit_data - circular_buffer);
+
+          lock();
+          ret_val = commit_index(index, commit_data);
+          unlock();
+          ASSERT(ret_val);
+
+          return ret_val;
+        }
+
+        /* Returns 'true' if data is available */
+        bool available()
+        {
+          lock();
+          bool ret_val = (CIRCULAR_BUFFER_ENTRY_COMMITED == entry_state[read_index]);
+          unlock();
+
+          return ret_val;
+        }
+        /* Reads and frees next buffer entry. Returns 0-memset data and nothing is freed if nothing to pop*/
+        T pop()
+        {
+          T ret_val;
+          memset(&ret_val, 0, sizeof(T));
+
+          lock();
+          if(CIRCULAR_BUFFER_ENTRY_COMMITED == entry_state[read_index])
+          {
+            ret_val = circular_buffer[read_index];
+            memset(&circular_buffer[read_index], 0, sizeof(T));
+            peek_outstanding = false;
+            free_read_entry();
+            notify_waiters();
+          }
+          unlock();
+
+          return ret_val;
+        }
+        /* Frees next buffer entry without returning data.  Does nothing if nothing to pop,
+            or if the entry returned by the last peek has since been evicted */
+        void pop_void()
+        {
+          lock();
+          if((0 == take_peek_evicted(1)) &&
+             (CIRCULAR_BUFFER_ENTRY_COMMITED == entry_state[read_index]))
+          {
+            memset(&circular_buffer[read_index], 0, sizeof(T));
+            free_read_entry();
+            notify_waiters();
+          }
+          unlock();
+        }
+        /* Returns next buffer entry without freeing. Returns nullptr if no data is available.  Data remains valid until pop is called */
+        const T* peek_ptr()
+        {
+          const T* ret_ptr = nullptr;
+
+          lock();
+          if(CIRCULAR_BUFFER_ENTRY_COMMITED == entry_state[read_index])
+          {
+            ret_ptr = &circular_buffer[read_index];
+            mark_peek();
+          }
+          unlock();
+
+          return ret_ptr;
+        }
+        /* Returns next buffer entry without freeing, returns 0-memset data if no data is available  */
+        T peek()
+        {
+          T ret_val;
+          memset(&ret_val, 0, sizeof(T));
+
+          lock();
+          if(CIRCULAR_BUFFER_ENTRY_COMMITED == entry_state[read_index])
+          {
+            ret_val = circular_buffer[read_index];
+            mark_peek();
+          }
+          unlock();
+
+          return ret_val;
+        }
+
+        /* Bulk consumer API - one lock per batch rather than per entry */
+        /* Returns up to max_count commited entries without freeing as at most two contiguous spans
+            (second span is used when entries wrap the end of the buffer).  Returns total entries in both spans.
+            Data remains valid until popped */
+        circular_buffer_index_t peek_span(span_c* first, span_c* second, circular_buffer_index_t max_count)
+        {
+          circular_buffer_index_t count = 0;
+          circular_buffer_index_t start;
+
+          ASSERT(first);
+          ASSERT(second);
+
+          lock();
+          start = read_index;
+          while((count < max_count) && (count < buffer_size) &&
+                (CIRCULAR_BUFFER_ENTRY_COMMITED == entry_state[wrap_index(start + count)]))
+          {
+            count++;
+          }
+          mark_peek();
+          unlock();
+
+          /* Split at end of buffer */
+          first->entries  = &circular_buffer[start];
+          first->count    = ((start + count) > buffer_size) ? (buffer_size - start) : count;
+          second->entries = &circular_buffer[0];
+          second->count   = count - first->count;
+
+          return count;
+        }
+        /* Frees up to count commited entries without returning data.  Returns number of entries freed.
+            After a peek, entries of the peek already evicted by forced pushes count towards count but are not freed again,
+              their number is returned in evicted (if not null) */
+        circular_buffer_index_t pop_n(circular_buffer_index_t count, circular_buffer_index_t* evicted=nullptr)
+        {
+          circular_buffer_index_t popped = 0;
+
+          lock();
+          const circular_buffer_index_t peek_evicted = take_peek_evicted(count);
+          count -= peek_evicted;
+          if(evicted)
+          {
+            *evicted = peek_evicted;
+          }
+          while((popped < count) &&
+                (CIRCULAR_BUFFER_ENTRY_COMMITED == entry_state[read_index]))
+          {
+            free_read_entry();
+            popped++;
+          }
+          notify_waiters();
+          unlock();
+
+          return popped;
+        }
+
+        /* Returns number of entries evicted by forced pushes and clears the count */
+        circular_buffer_index_t get_and_clear_evicted_count()
+        {
+          lock();
+          circular_buffer_index_t ret_val = evicted_count;
+          evicted_count = 0;
+          unlock();
+
+          return ret_val;
+        }
+
+        /* Blocking waits - at most one waiting consumer and one waiting producer at a time.
+            Waiters sleep on their SL_ROBOT_NOTIFY_INDEX_BUFFER task notification and are only woken once the watermark is crossed.
+            Requires a mutexed buffer (static buffers after init_mutex()).
+            Returns 'true' if the watermark was reached before timeout (ms) */
+        /* Waits until at least watermark commited entries are available */
+        bool wait_available(time_ms_t timeout=SL_ROBOT_WAIT_FOREVER, circular_buffer_index_t watermark=1)
+        {
+          return wait_watermark(&available_waiter, watermark, timeout);
+        }
+        /* Waits until at least watermark entries are free */
+        bool wait_space(time_ms_t timeout=SL_ROBOT_WAIT_FOREVER, circular_buffer_index_t watermark=1)
+        {
+          return wait_watermark(&space_waiter, watermark, timeout);
+        }
+    };
+  }
+}
+
+#endif /* __SL_ROBOT_CIRCULAR_BUFFER_CORE_HPP__ */
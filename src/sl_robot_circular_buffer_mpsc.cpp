@@ -0,0 +1,207 @@
+/*
+  sl_robot_circular_buffer_mpsc.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <new>
+
+#include "sl_robot_circular_buffer_mpsc.hpp"
+
+using namespace sandor_laboratories::robot;
+
+template <typename T>
+circular_buffer_mpsc_c<T>::circular_buffer_mpsc_c(circular_buffer_index_t constructor_size)
+  : buffer_size(constructor_size), buffer_mask(constructor_size-1), write_position(0), read_position(0)
+{
+  /* Power of 2 size required for free running positions to wrap cleanly */
+  ASSERT((buffer_size > 0) && (0 == (buffer_size & buffer_mask)));
+
+  sequence        = (std::atomic<circular_buffer_index_t>*) heap_malloc(buffer_size*sizeof(std::atomic<circular_buffer_index_t>));
+  circular_buffer = (T*) heap_malloc(buffer_size*sizeof(T));
+  memset(circular_buffer, 0, (buffer_size*sizeof(T)));
+
+  for(circular_buffer_index_t i = 0; i < buffer_size; i++)
+  {
+    new (&sequence[i]) std::atomic<circular_buffer_index_t>(i);
+  }
+}
+template <typename T>
+circular_buffer_mpsc_c<T>::~circular_buffer_mpsc_c()
+{
+  heap_free((void*)circular_buffer);
+  heap_free((void*)sequence);
+}
+
+/* Push item into buffer (by copy), returns 'true' if successful.  Data is never overwritten */
+template <typename T>
+bool circular_buffer_mpsc_c<T>::push(const T* input)
+{
+  bool ret_val = false;
+
+  T* entry = allocate();
+  if(entry)
+  {
+    *entry  = *input;
+    ret_val = commit(entry);
+  }
+
+  return ret_val;
+}
+/* Returns pointer to next available entry or 'nullpointer' if no free entries.  Pointer remains writable and cannot be read until commited.  */
+template <typename T>
+T* circular_buffer_mpsc_c<T>::allocate()
+{
+  T* ret_ptr = nullptr;
+
+  circular_buffer_index_t position = write_position.load(std::memory_order_relaxed);
+
+  while(nullptr == ret_ptr)
+  {
+    const circular_buffer_index_t slot_sequence = sequence[position & buffer_mask].load(std::memory_order_acquire);
+    const int                     difference    = (int) (slot_sequence - position);
+
+    if(0 == difference)
+    {
+      /* Slot is free, try to claim it.  On failure position is reloaded with the latest write_position */
+      if(write_position.compare_exchange_weak(position, position+1, std::memory_order_relaxed))
+      {
+        ret_ptr = &circular_buffer[position & buffer_mask];
+      }
+    }
+    else if(difference < 0)
+    {
+      /* Slot still holds data from the previous lap, buffer is full */
+      break;
+    }
+    else
+    {
+      /* Another producer claimed this position, retry with latest */
+      position = write_position.load(std::memory_order_relaxed);
+    }
+  }
+
+  return ret_ptr;
+}
+/* Commits allocated entry for reading.  Returns 'true' if successful */
+template <typename T>
+bool circular_buffer_mpsc_c<T>::commit(const T* commit_data)
+{
+  bool ret_val = false;
+
+  if((commit_data >= circular_buffer) &&
+     (commit_data <  &circular_buffer[buffer_size]))
+  {
+    /* Slot is owned by the committing producer, so its sequence still equals the reserved position */
+    std::atomic<circular_buffer_index_t> *slot_sequence = &sequence[commit_data - circular_buffer];
+    slot_sequence->store(slot_sequence->load(std::memory_order_relaxed)+1, std::memory_order_release);
+    ret_val = true;
+  }
+  ASSERT(ret_val);
+
+  return ret_val;
+}
+
+/* Returns 'true' if data is available */
+template <typename T>
+bool circular_buffer_mpsc_c<T>::available() const
+{
+  return ((read_position+1) == sequence[read_position & buffer_mask].load(std::memory_order_acquire));
+}
+/* Reads and frees next buffer entry. Returns 0-memset data and nothing is freed if nothing to pop*/
+template <typename T>
+T circular_buffer_mpsc_c<T>::pop()
+{
+  T ret_val;
+  memset(&ret_val, 0, sizeof(T));
+
+  const T* entry = peek_ptr();
+  if(entry)
+  {
+    ret_val = *entry;
+    pop_void();
+  }
+
+  return ret_val;
+}
+/* Frees next buffer entry without returning data.  Does nothing if nothing to pop */
+template <typename T>
+void circular_buffer_mpsc_c<T>::pop_void()
+{
+  if(available())
+  {
+    /* Release slot to the producer one lap ahead */
+    sequence[read_position & buffer_mask].store(read_position+buffer_size, std::memory_order_release);
+    read_position++;
+  }
+}
+/* Returns next buffer entry without freeing. Returns nullptr if no data is available.  Data remains valid until pop is called */
+template <typename T>
+const T* circular_buffer_mpsc_c<T>::peek_ptr() const
+{
+  const T* ret_ptr = nullptr;
+
+  if(available())
+  {
+    ret_ptr = &circular_buffer[read_position & buffer_mask];
+  }
+
+  return ret_ptr;
+}
+/* Returns next buffer entry without freeing, returns 0-memset data if no data is available  */
+template <typename T>
+T circular_buffer_mpsc_c<T>::peek() const
+{
+  T ret_val;
+  memset(&ret_val, 0, sizeof(T));
+
+  const T* entry = peek_ptr();
+  if(entry)
+  {
+    ret_val = *entry;
+  }
+
+  return ret_val;
+}
+
+/* Returns up to max_count commited entries without freeing as at most two contiguous spans 
+    (second span is used when entries wrap the end of the buffer).  Returns total entries in both spans.
+    Data remains valid until popped */
+template <typename T>
+circular_buffer_index_t circular_buffer_mpsc_c<T>::peek_span(span_c* first, span_c* second, circular_buffer_index_t max_count) const
+{
+  circular_buffer_index_t count = 0;
+
+  ASSERT(first);
+  ASSERT(second);
+
+  while((count < max_count) && (count < buffer_size) &&
+        ((read_position+count+1) == sequence[(read_position+count) & buffer_mask].load(std::memory_order_acquire)))
+  {
+    count++;
+  }
+
+  /* Split at end of buffer */
+  const circular_buffer_index_t start = (read_position & buffer_mask);
+  first->entries  = &circular_buffer[start];
+  first->count    = ((start + count) > buffer_size) ? (buffer_size - start) : count;
+  second->entries = &circular_buffer[0];
+  second->count   = count - first->count;
+
+  return count;
+}
+/* Frees up to count commited entries without returning data.  Returns number of entries freed */
+template <typename T>
+circular_buffer_index_t circular_buffer_mpsc_c<T>::pop_n(circular_buffer_index_t count)
+{
+  circular_buffer_index_t popped = 0;
+
+  while((popped < count) && available())
+  {
+    pop_void();
+    popped++;
+  }
+
+  return popped;
+}
@@ -0,0 +1,99 @@
+/*
+  sl_robot_circular_buffer_mpsc.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_ROBOT_CIRCULAR_BUFFER_MPSC_HPP__
+#define __SL_ROBOT_CIRCULAR_BUFFER_MPSC_HPP__
+
+#include <atomic>
+
+#include "sl_robot_circular_buffer.hpp"
+#include "sl_robot_log.hpp"
+#include "sl_robot_utils.hpp"
+
+namespace sandor_laboratories
+{
+  namespace robot
+  {
+    /* Lock-free circular buffer for many producers (tasks and interrupts) and a single consumer.
+        Each slot carries a sequence number:
+          sequence == position     -> slot is free for the producer reserving 'position'
+          sequence == position + 1 -> slot is commited and readable by the consumer
+        Producers reserve slots with a compare-and-swap on write_position and never block,
+          so allocate() and commit() may be called from interrupt context.
+        The consumer drains strictly in reservation order, stopping at the first uncommited slot. */
+    template <typename T>
+    class circular_buffer_mpsc_c
+    {
+      private:
+        /* Config Data - size must be a power of 2 */
+        const circular_buffer_index_t buffer_size;
+        const circular_buffer_index_t buffer_mask;
+
+        /* Buffer */
+        std::atomic<circular_buffer_index_t> *sequence;
+        T                                    *circular_buffer;
+
+        /* Iterators (free running, wrapped with buffer_mask) - padded so producer and consumer positions never share a cache line */
+        std::atomic<circular_buffer_index_t>  write_position;
+        uint8_t                               write_position_pad[SL_ROBOT_CACHE_LINE_SIZE];
+        circular_buffer_index_t               read_position;
+        uint8_t                               read_position_pad[SL_ROBOT_CACHE_LINE_SIZE];
+
+      public:
+        /* Read-only view of contiguous commited entries returned by peek_span() */
+        class span_c
+        {
+          friend class circular_buffer_mpsc_c;
+
+          private:
+            const T*                entries;
+            circular_buffer_index_t count;
+
+          public:
+            span_c() : entries(nullptr), count(0) {}
+
+            circular_buffer_index_t size() const {return count;}
+            const T& operator[](circular_buffer_index_t i) const {return entries[i];}
+        };
+
+        circular_buffer_mpsc_c(circular_buffer_index_t size);
+        ~circular_buffer_mpsc_c();
+
+        /* Producer API - safe from any task or interrupt */
+        /* Push item into buffer (by copy), returns 'true' if successful.  Data is never overwritten */
+        bool     push(const T* input);
+        /* Returns pointer to next available entry or 'nullpointer' if no free entries.  Pointer remains writable and cannot be read until commited.  */
+        T*       allocate();
+        /* Commits allocated entry for reading.  Returns 'true' if successful */
+        bool     commit(const T*);
+
+        /* Consumer API - single consumer only */
+        /* Returns 'true' if data is available */
+        bool     available() const;
+        /* Reads and frees next buffer entry. Returns 0-memset data and nothing is freed if nothing to pop*/
+        T        pop();
+        /* Frees next buffer entry without returning data.  Does nothing if nothing to pop */
+        void     pop_void();
+        /* Returns next buffer entry without freeing. Returns nullptr if no data is available.  Data remains valid until pop is called */
+        const T* peek_ptr() const;
+        /* Returns next buffer entry without freeing, returns 0-memset data if no data is available  */
+        T        peek() const;
+
+        /* Bulk consumer API */
+        /* Returns up to max_count commited entries without freeing as at most two contiguous spans 
+            (second span is used when entries wrap the end of the buffer).  Returns total entries in both spans.
+            Data remains valid until popped */
+        circular_buffer_index_t peek_span(span_c* first, span_c* second, circular_buffer_index_t max_count) const;
+        /* Frees up to count commited entries without returning data.  Returns number of entries freed */
+        circular_buffer_index_t pop_n(circular_buffer_index_t count);
+    };
+
+    template class circular_buffer_mpsc_c<log_entry_s>;
+  }
+}
+
+#endif /* __SL_ROBOT_CIRCULAR_BUFFER_MPSC_HPP__ */
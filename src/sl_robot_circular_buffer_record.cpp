@@ -0,0 +1,233 @@
+/*
+  sl_robot_circular_buffer_record.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <cstring>
+
+#include "sl_robot_circular_buffer_record.hpp"
+
+using namespace sandor_laboratories::robot;
+
+circular_buffer_record_c::circular_buffer_record_c(circular_buffer_index_t constructor_size, bool constructor_single_producer)
+  : buffer_size(constructor_size), buffer_mask(constructor_size-1), single_producer(constructor_single_producer), 
+    write_position(0), read_position(0)
+{
+  /* Power of 2 size required for free running positions to wrap cleanly */
+  ASSERT((buffer_size >= RECORD_ALIGNMENT) && (0 == (buffer_size & buffer_mask)));
+
+  circular_buffer = (uint8_t*) heap_malloc(buffer_size);
+  ASSERT(0 == (((uintptr_t) circular_buffer) & (RECORD_ALIGNMENT-1)));
+  memset(circular_buffer, 0, buffer_size);
+}
+circular_buffer_record_c::~circular_buffer_record_c()
+{
+  heap_free((void*)circular_buffer);
+}
+
+/* Zeroes length bytes from position, wrapping at the end of the buffer */
+void circular_buffer_record_c::zero(circular_buffer_index_t position, circular_buffer_index_t length)
+{
+  const circular_buffer_index_t offset = (position & buffer_mask);
+  const circular_buffer_index_t first  = ((offset + length) > buffer_size) ? (buffer_size - offset) : length;
+
+  memset(&circular_buffer[offset], 0, first);
+  memset(&circular_buffer[0], 0, (length - first));
+}
+
+/* Returns pointer to length contiguous, word aligned bytes or 'nullpointer' if there is not enough free space 
+    while keeping 'reserve' bytes free for other allocations.  Pointer remains writable and cannot be read until commited.  */
+void* circular_buffer_record_c::allocate(size_t length, circular_buffer_index_t reserve)
+{
+  void* ret_ptr = nullptr;
+
+  if((reserve < buffer_size) && (length <= (buffer_size - reserve - sizeof(record_header_t))))
+  {
+    const circular_buffer_index_t size     = record_size(length);
+    circular_buffer_index_t       position = write_position.load(std::memory_order_relaxed);
+    circular_buffer_index_t       padding;
+    bool                          reserved = false;
+
+    while(!reserved)
+    {
+      const circular_buffer_index_t offset = (position & buffer_mask);
+      /* Pad to the end of the buffer if the record would not be contiguous */
+      padding = ((offset + size) > buffer_size) ? (buffer_size - offset) : 0;
+
+      /* Acquire read_position so bytes zeroed by the consumer are seen before they are reused */
+      if(((position - read_position.load(std::memory_order_acquire)) + padding + size + reserve) > buffer_size)
+      {
+        break;
+      }
+      else if(single_producer)
+      {
+        reserved = true;
+      }
+      else
+      {
+        /* On failure position is reloaded with the latest write_position */
+        reserved = write_position.compare_exchange_weak(position, (position + padding + size), std::memory_order_relaxed);
+      }
+    }
+
+    if(reserved)
+    {
+      if(padding)
+      {
+        header_at(position)->store(RECORD_COMMITTED | RECORD_PADDING | padding, std::memory_order_relaxed);
+      }
+      header_at(position+padding)->store((record_header_t) length, std::memory_order_relaxed);
+      if(single_producer)
+      {
+        /* Release so the consumer never reads a header beyond write_position before it is written */
+        write_position.store(position + padding + size, std::memory_order_release);
+      }
+      ret_ptr = &circular_buffer[((position+padding) & buffer_mask) + sizeof(record_header_t)];
+    }
+  }
+
+  return ret_ptr;
+}
+/* Commits allocated record for reading.  Returns 'true' if successful */
+bool circular_buffer_record_c::commit(const void* commit_data)
+{
+  return commit(commit_data, RECORD_LENGTH_MASK);
+}
+/* Commits allocated record shrunk to its first length bytes, for records allocated at a maximum length before the length is known.
+    Unused bytes are returned to the buffer if no later record was allocated, otherwise they are skipped as padding */
+bool circular_buffer_record_c::commit(const void* commit_data, size_t length)
+{
+  bool ret_val = false;
+  const uint8_t * const record = (const uint8_t *) commit_data;
+
+  if((record >= &circular_buffer[sizeof(record_header_t)]) &&
+     (record <  &circular_buffer[buffer_size]))
+  {
+    /* Record is owned by the commiting producer, so only this producer may set its commited flag */
+    const circular_buffer_index_t offset = (circular_buffer_index_t) (record - circular_buffer - sizeof(record_header_t));
+    std::atomic<record_header_t> *header = header_at(offset);
+    const record_header_t header_value = header->load(std::memory_order_relaxed);
+    const size_t          allocated_length = (header_value & RECORD_LENGTH_MASK);
+    ASSERT(!(header_value & RECORD_COMMITTED));
+
+    if(length < allocated_length)
+    {
+      const circular_buffer_index_t allocated_size = record_size(allocated_length);
+      const circular_buffer_index_t size           = record_size(length);
+      if(size < allocated_size)
+      {
+        /* The consumer cannot pass this busy record, so write_position is less than a lap ahead of it */
+        circular_buffer_index_t position = write_position.load(std::memory_order_relaxed);
+        bool                    returned = false;
+        if((position & buffer_mask) == ((offset + allocated_size) & buffer_mask))
+        {
+          if(single_producer)
+          {
+            write_position.store(position - (allocated_size - size), std::memory_order_release);
+            returned = true;
+          }
+          else
+          {
+            /* Last record allocated, give the unused bytes back zeroed, as later headers will be written there */
+            zero(offset + size, (allocated_size - size));
+            returned = write_position.compare_exchange_strong(position, (position - (allocated_size - size)),
+                                                              std::memory_order_release, std::memory_order_relaxed);
+          }
+        }
+        if(!returned)
+        {
+          header_at(offset + size)->store(RECORD_COMMITTED | RECORD_PADDING | (allocated_size - size), std::memory_order_relaxed);
+        }
+      }
+    }
+    else
+    {
+      length = allocated_length;
+    }
+
+    header->store(RECORD_COMMITTED | (record_header_t) length, std::memory_order_release);
+    ret_val = true;
+  }
+  ASSERT(ret_val);
+
+  return ret_val;
+}
+
+/* Returns 'true' if a commited record is available */
+bool circular_buffer_record_c::available() const
+{
+  size_t length;
+  return (nullptr != peek(&length));
+}
+/* Returns next commited record without freeing and its length through 'length'.  Returns nullptr if no record is available.
+    Data remains valid until pop is called */
+const void* circular_buffer_record_c::peek(size_t *length) const
+{
+  circular_buffer_index_t position = peek_position();
+  return peek_next(&position, length);
+}
+/* Frees next commited record.  Does nothing if nothing to pop */
+void circular_buffer_record_c::pop()
+{
+  circular_buffer_index_t position = peek_position();
+  size_t                  length;
+
+  if(peek_next(&position, &length))
+  {
+    pop_to(position);
+  }
+}
+
+/* Returns commited record at 'position' and its length through 'length', then advances 'position' past it.
+    Returns nullptr if no record is available.  Data remains valid until popped */
+const void* circular_buffer_record_c::peek_next(circular_buffer_index_t *position, size_t *length) const
+{
+  const void* ret_ptr = nullptr;
+
+  ASSERT(position);
+  ASSERT(length);
+
+  while((nullptr == ret_ptr) && (*position != write_position.load(std::memory_order_acquire)))
+  {
+    const record_header_t header_value = header_at(*position)->load(std::memory_order_acquire);
+
+    if(!(header_value & RECORD_COMMITTED))
+    {
+      /* Record is not yet commited, or its header not yet written */
+      break;
+    }
+    else if(header_value & RECORD_PADDING)
+    {
+      *position += (header_value & RECORD_LENGTH_MASK);
+    }
+    else
+    {
+      *length   = (header_value & RECORD_LENGTH_MASK);
+      ret_ptr   = &circular_buffer[(*position & buffer_mask) + sizeof(record_header_t)];
+      *position += record_size(*length);
+    }
+  }
+
+  return ret_ptr;
+}
+/* Frees all records before 'position' returned by peek_next() */
+void circular_buffer_record_c::pop_to(circular_buffer_index_t position)
+{
+  const circular_buffer_index_t start = read_position.load(std::memory_order_relaxed);
+  ASSERT((position - start) <= used());
+  if(!single_producer)
+  {
+    /* Headers are written after reservation, so freed bytes must read as unwritten (busy) headers when reused */
+    zero(start, (position - start));
+  }
+  /* Release so producers never reuse the records' bytes before the consumer is done reading */
+  read_position.store(position, std::memory_order_release);
+}
+
+/* Returns number of bytes currently reserved, including headers and padding */
+circular_buffer_index_t circular_buffer_record_c::used() const
+{
+  return (write_position.load(std::memory_order_acquire) - read_position.load(std::memory_order_acquire));
+}
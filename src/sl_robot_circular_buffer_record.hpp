@@ -0,0 +1,111 @@
+/*
+  sl_robot_circular_buffer_record.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_ROBOT_CIRCULAR_BUFFER_RECORD_HPP__
+#define __SL_ROBOT_CIRCULAR_BUFFER_RECORD_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "sl_robot_circular_buffer.hpp"
+#include "sl_robot_utils.hpp"
+
+namespace sandor_laboratories
+{
+  namespace robot
+  {
+    /* Byte-oriented circular buffer of variable-length records for many producers (tasks and interrupts) and a single consumer.
+        Each record is a 4 byte length header followed by the record data, padded to 4 bytes, and is always contiguous.
+        A record that would cross the end of the buffer is preceded by a padding record filling the remaining bytes.
+        Producers reserve space with a compare-and-swap on write_position and never block or mask interrupts,
+          commit sets the commited flag and records are readable once all earlier records are commited.
+        A header is written only after its space is reserved, so the consumer zeroes the bytes it frees
+          and a header not yet written reads as busy.  Record boundaries move between laps, so all freed bytes are zeroed.
+        A record may be shrunk when commited, unused bytes are returned with another compare-and-swap.
+        A buffer constructed for a single producer publishes headers before write_position and skips the zeroing.
+        The consumer never locks. */
+    class circular_buffer_record_c
+    {
+      private:
+        typedef uint32_t record_header_t;
+        /* Record is readable, headers without it (including unwritten, zeroed headers) are busy */
+        static constexpr record_header_t RECORD_COMMITTED   = 0x80000000;
+        /* Record only pads to the end of the buffer or a shrunk record and carries no data */
+        static constexpr record_header_t RECORD_PADDING     = 0x40000000;
+        static constexpr record_header_t RECORD_LENGTH_MASK = 0x3FFFFFFF;
+        static constexpr size_t          RECORD_ALIGNMENT   = sizeof(record_header_t);
+
+        /* Config Data - size in bytes, must be a power of 2 */
+        const circular_buffer_index_t buffer_size;
+        const circular_buffer_index_t buffer_mask;
+        const bool                    single_producer;
+
+        /* Buffer */
+        uint8_t *circular_buffer;
+
+        /* Iterators (free running byte positions, wrapped with buffer_mask) - padded so producer and consumer positions never share a cache line */
+        std::atomic<circular_buffer_index_t> write_position;
+        uint8_t                              write_position_pad[SL_ROBOT_CACHE_LINE_SIZE];
+        std::atomic<circular_buffer_index_t> read_position;
+        uint8_t                              read_position_pad[SL_ROBOT_CACHE_LINE_SIZE];
+
+        inline std::atomic<record_header_t> * header_at(circular_buffer_index_t position) const
+          {return (std::atomic<record_header_t> *) &circular_buffer[position & buffer_mask];}
+        /* Zeroes length bytes from position, wrapping at the end of the buffer */
+        void zero(circular_buffer_index_t position, circular_buffer_index_t length);
+
+      public:
+        /* Returns bytes a record of length occupies in the buffer, including its header and alignment.
+            A record that wraps is also preceded by padding of up to its own size */
+        static constexpr circular_buffer_index_t record_size(size_t length)
+          {return (circular_buffer_index_t) ((sizeof(record_header_t) + length + (RECORD_ALIGNMENT-1)) & ~(RECORD_ALIGNMENT-1));}
+
+        /* A single_producer buffer must only ever be written by one task and never from interrupts */
+        circular_buffer_record_c(circular_buffer_index_t size, bool single_producer = false);
+        ~circular_buffer_record_c();
+
+        /* Producer API */
+        /* Returns pointer to length contiguous, word aligned bytes or 'nullpointer' if there is not enough free space 
+            while keeping 'reserve' bytes free for other allocations.  Pointer remains writable and cannot be read until commited.  */
+        void*                   allocate(size_t length, circular_buffer_index_t reserve = 0);
+        /* Commits allocated record for reading.  Returns 'true' if successful */
+        bool                    commit(const void*);
+        /* Commits allocated record shrunk to its first length bytes, for records allocated at a maximum length before the length is known.
+            Unused bytes are returned to the buffer if no later record was allocated, otherwise they are skipped as padding */
+        bool                    commit(const void*, size_t length);
+
+        /* Consumer API */
+        /* Returns 'true' if a commited record is available */
+        bool                    available() const;
+        /* Returns next commited record without freeing and its length through 'length'.  Returns nullptr if no record is available.
+            Data remains valid until pop is called */
+        const void*             peek(size_t *length) const;
+        /* Frees next commited record.  Does nothing if nothing to pop */
+        void                    pop();
+
+        /* Batch consumer API - iterates commited records without freeing so a batch can be freed at once */
+        /* Returns position of next record to be read, to start iteration with peek_next() */
+        inline circular_buffer_index_t peek_position() const {return read_position.load(std::memory_order_relaxed);}
+        /* Returns commited record at 'position' and its length through 'length', then advances 'position' past it.
+            Returns nullptr if no record is available.  Data remains valid until popped */
+        const void*             peek_next(circular_buffer_index_t *position, size_t *length) const;
+        /* Frees all records before 'position' returned by peek_next() */
+        void                    pop_to(circular_buffer_index_t position);
+
+        /* Returns number of bytes currently reserved, including headers and padding */
+        circular_buffer_index_t used() const;
+        /* Returns 'true' if pointer is within the buffer */
+        inline bool contains(const void* ptr) const 
+          {return ((((const uint8_t*) ptr) >= circular_buffer) && (((const uint8_t*) ptr) < &circular_buffer[buffer_size]));}
+        /* Returns total size of buffer in bytes */
+        inline circular_buffer_index_t size() const {return buffer_size;}
+    };
+  }
+}
+
+#endif /* __SL_ROBOT_CIRCULAR_BUFFER_RECORD_HPP__ */
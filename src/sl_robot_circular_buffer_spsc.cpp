@@ -0,0 +1,145 @@
+/*
+  sl_robot_circular_buffer_spsc.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include "sl_robot_circular_buffer_spsc.hpp"
+
+using namespace sandor_laboratories::robot;
+
+template <typename T>
+circular_buffer_spsc_c<T>::circular_buffer_spsc_c(circular_buffer_index_t constructor_size)
+  : buffer_slots(constructor_size+1), read_index(0), write_index(0), allocated(false)
+{
+  circular_buffer = (T*) heap_malloc(buffer_slots*sizeof(T));
+  memset(circular_buffer, 0, (buffer_slots*sizeof(T)));
+}
+template <typename T>
+circular_buffer_spsc_c<T>::~circular_buffer_spsc_c()
+{
+  heap_free((void*)circular_buffer);
+}
+
+/* Push item into buffer (by copy), returns 'true' if successful.
+    Data is never overwritten as the producer may not move the read side */
+template <typename T>
+bool circular_buffer_spsc_c<T>::push(const T* input)
+{
+  bool ret_val = false;
+
+  const circular_buffer_index_t write = write_index.load(std::memory_order_relaxed);
+  const circular_buffer_index_t next  = next_index(write);
+
+  if((false == allocated) &&
+     (next != read_index.load(std::memory_order_acquire)))
+  {
+    circular_buffer[write] = *input;
+    write_index.store(next, std::memory_order_release);
+    ret_val = true;
+  }
+
+  return ret_val;
+}
+/* Returns pointer to next available entry or 'nullpointer' if no free entries or an entry is already allocated.
+    Pointer remains writable and cannot be read until commited.  */
+template <typename T>
+T* circular_buffer_spsc_c<T>::allocate()
+{
+  T* ret_ptr = nullptr;
+
+  const circular_buffer_index_t write = write_index.load(std::memory_order_relaxed);
+
+  if((false == allocated) &&
+     (next_index(write) != read_index.load(std::memory_order_acquire)))
+  {
+    ret_ptr   = &circular_buffer[write];
+    allocated = true;
+  }
+
+  return ret_ptr;
+}
+/* Commits allocated entry for reading.  Returns 'true' if successful */
+template <typename T>
+bool circular_buffer_spsc_c<T>::commit(const T* commit_data)
+{
+  bool ret_val = false;
+
+  const circular_buffer_index_t write = write_index.load(std::memory_order_relaxed);
+
+  if(allocated && (&circular_buffer[write] == commit_data))
+  {
+    allocated = false;
+    write_index.store(next_index(write), std::memory_order_release);
+    ret_val = true;
+  }
+  ASSERT(ret_val);
+
+  return ret_val;
+}
+
+/* Returns 'true' if data is available */
+template <typename T>
+bool circular_buffer_spsc_c<T>::available() const
+{
+  return (read_index.load(std::memory_order_relaxed) != write_index.load(std::memory_order_acquire));
+}
+/* Reads and frees next buffer entry. Returns 0-memset data and nothing is freed if nothing to pop*/
+template <typename T>
+T circular_buffer_spsc_c<T>::pop()
+{
+  T ret_val;
+  memset(&ret_val, 0, sizeof(T));
+
+  const circular_buffer_index_t read = read_index.load(std::memory_order_relaxed);
+
+  if(read != write_index.load(std::memory_order_acquire))
+  {
+    ret_val = circular_buffer[read];
+    read_index.store(next_index(read), std::memory_order_release);
+  }
+
+  return ret_val;
+}
+/* Frees next buffer entry without returning data.  Does nothing if nothing to pop */
+template <typename T>
+void circular_buffer_spsc_c<T>::pop_void()
+{
+  const circular_buffer_index_t read = read_index.load(std::memory_order_relaxed);
+
+  if(read != write_index.load(std::memory_order_acquire))
+  {
+    read_index.store(next_index(read), std::memory_order_release);
+  }
+}
+/* Returns next buffer entry without freeing. Returns nullptr if no data is available.  Data remains valid until pop is called */
+template <typename T>
+const T* circular_buffer_spsc_c<T>::peek_ptr() const
+{
+  const T* ret_ptr = nullptr;
+
+  const circular_buffer_index_t read = read_index.load(std::memory_order_relaxed);
+
+  if(read != write_index.load(std::memory_order_acquire))
+  {
+    ret_ptr = &circular_buffer[read];
+  }
+
+  return ret_ptr;
+}
+/* Returns next buffer entry without freeing, returns 0-memset data if no data is available  */
+template <typename T>
+T circular_buffer_spsc_c<T>::peek() const
+{
+  T ret_val;
+  memset(&ret_val, 0, sizeof(T));
+
+  const T* entry = peek_ptr();
+  if(entry)
+  {
+    ret_val = *entry;
+  }
+
+  return ret_val;
+}
@@ -0,0 +1,78 @@
+/*
+  sl_robot_circular_buffer_spsc.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_ROBOT_CIRCULAR_BUFFER_SPSC_HPP__
+#define __SL_ROBOT_CIRCULAR_BUFFER_SPSC_HPP__
+
+#include <atomic>
+
+#include "sl_robot_circular_buffer.hpp"
+#include "sl_robot_log.hpp"
+#include "sl_robot_utils.hpp"
+
+namespace sandor_laboratories
+{
+  namespace robot
+  {
+    /* Lock-free circular buffer for exactly one producer task and one consumer task.
+        Producer only writes write_index and consumer only writes read_index,
+        each published with release ordering and observed with acquire ordering.
+        No mutex or critical section is ever taken. */
+    template <typename T>
+    class circular_buffer_spsc_c
+    {
+      private:
+        /* Config Data - one extra slot is kept empty to distinguish full from empty */
+        const circular_buffer_index_t buffer_slots;
+
+        /* Buffer */
+        T* circular_buffer;
+
+        /* Iterators - padded so producer and consumer indices never share a cache line */
+        std::atomic<circular_buffer_index_t> read_index;
+        uint8_t                              read_index_pad[SL_ROBOT_CACHE_LINE_SIZE];
+        std::atomic<circular_buffer_index_t> write_index;
+        uint8_t                              write_index_pad[SL_ROBOT_CACHE_LINE_SIZE];
+
+        /* Producer-owned flag, only one entry may be allocated at a time */
+        bool allocated;
+
+        inline circular_buffer_index_t next_index(circular_buffer_index_t index) const
+          {return ((index+1) < buffer_slots) ? (index+1) : 0;}
+
+      public:
+        circular_buffer_spsc_c(circular_buffer_index_t size);
+        ~circular_buffer_spsc_c();
+
+        /* Producer API */
+        /* Push item into buffer (by copy), returns 'true' if successful.
+            Data is never overwritten as the producer may not move the read side */
+        bool     push(const T* input);
+        /* Returns pointer to next available entry or 'nullpointer' if no free entries or an entry is already allocated.
+            Pointer remains writable and cannot be read until commited.  */
+        T*       allocate();
+        /* Commits allocated entry for reading.  Returns 'true' if successful */
+        bool     commit(const T*);
+
+        /* Consumer API */
+        /* Returns 'true' if data is available */
+        bool     available() const;
+        /* Reads and frees next buffer entry. Returns 0-memset data and nothing is freed if nothing to pop*/
+        T        pop();
+        /* Frees next buffer entry without returning data.  Does nothing if nothing to pop */
+        void     pop_void();
+        /* Returns next buffer entry without freeing. Returns nullptr if no data is available.  Data remains valid until pop is called */
+        const T* peek_ptr() const;
+        /* Returns next buffer entry without freeing, returns 0-memset data if no data is available  */
+        T        peek() const;
+    };
+
+    template class circular_buffer_spsc_c<log_entry_s>;
+  }
+}
+
+#endif /* __SL_ROBOT_CIRCULAR_BUFFER_SPSC_HPP__ */
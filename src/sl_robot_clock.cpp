@@ -0,0 +1,165 @@
+/*
+  sl_robot_clock.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <Arduino.h>
+#include <atomic>
+
+#if !defined(__IMXRT1062__) && defined(__unix__)
+#include <time.h>
+#endif
+
+#include "sl_robot_clock.hpp"
+#include "sl_robot_utils.hpp"
+
+using namespace sandor_laboratories::robot;
+
+/* Nominal tick frequency, converts ticks to microseconds until clock_init() reads the actual frequency */
+#if defined(__IMXRT1062__)
+#define CLOCK_TICKS_PER_US_NOMINAL (F_CPU / 1000000)
+#elif defined(__unix__)
+#define CLOCK_TICKS_PER_US_NOMINAL 1000
+#else
+#define CLOCK_TICKS_PER_US_NOMINAL 1
+#endif
+
+/* Shift keeping the multiplier within (2^31, 2^32], floor(log2(ticks_per_us)) */
+static constexpr uint8_t clock_us_shift_for(uint32_t ticks_per_us, uint8_t shift=0)
+{
+  return ((2ULL << shift) > ticks_per_us) ? shift : clock_us_shift_for(ticks_per_us, (shift+1));
+}
+/* Reciprocal of ticks_per_us scaled by 2^(32+shift), rounded up so exact tick counts never convert low */
+static constexpr uint64_t clock_us_multiplier_for(uint32_t ticks_per_us)
+{
+  return (((1ULL << (32 + clock_us_shift_for(ticks_per_us))) + ticks_per_us - 1) / ticks_per_us);
+}
+
+uint64_t sandor_laboratories::robot::clock_us_multiplier = clock_us_multiplier_for(CLOCK_TICKS_PER_US_NOMINAL);
+uint8_t  sandor_laboratories::robot::clock_us_shift      = clock_us_shift_for(CLOCK_TICKS_PER_US_NOMINAL);
+
+static void clock_us_conversion_init()
+{
+  const uint32_t ticks_per_us = (uint32_t) (clock_ticks_per_second() / 1000000);
+  clock_us_multiplier = clock_us_multiplier_for(ticks_per_us);
+  clock_us_shift      = clock_us_shift_for(ticks_per_us);
+}
+
+#if defined(__IMXRT1062__) || !defined(__unix__)
+/* 32-bit counter extension, lock-free so tasks and interrupts read the clock without masking interrupts.
+    The last extended reading is published in one of two snapshots, selected by clock_generation.
+    Readers extend the counter from the published snapshot and retry if a newer one is published meanwhile.
+    One reader at a time (clock_updating) writes the unpublished snapshot and publishes it, 
+      an interrupted update only skips updates and never blocks readers.
+    millis() is recorded with each snapshot, so whole counter periods elapsed since are counted even if no read saw the wrap */
+typedef struct
+{
+  uint32_t      counter;
+  uint32_t      counter_ms;
+  clock_ticks_t ticks;
+} clock_snapshot_s;
+static volatile clock_snapshot_s clock_snapshots[2];
+static std::atomic<uint32_t>     clock_generation;
+static std::atomic<bool>         clock_updating;
+static uint32_t                  clock_ticks_per_ms;
+
+/* Read from interrupts, a lock-based fallback would deadlock */
+static_assert((2 == ATOMIC_INT_LOCK_FREE) && (2 == ATOMIC_BOOL_LOCK_FREE), "clock requires lock-free atomics");
+
+static inline uint32_t clock_counter()
+{
+  #if defined(__IMXRT1062__)
+  return ARM_DWT_CYCCNT;
+  #else
+  return micros();
+  #endif
+}
+
+clock_ticks_t sandor_laboratories::robot::clock_ticks()
+{
+  uint32_t      generation;
+  uint32_t      counter;
+  uint32_t      counter_ms;
+  uint32_t      snapshot_counter;
+  uint32_t      snapshot_counter_ms;
+  clock_ticks_t snapshot_ticks;
+
+  /* Counter is read after the snapshot, so it is never older than the snapshot */
+  do
+  {
+    generation = clock_generation.load(std::memory_order_acquire);
+    const volatile clock_snapshot_s * const snapshot = &clock_snapshots[generation & 1];
+    snapshot_counter    = snapshot->counter;
+    snapshot_counter_ms = snapshot->counter_ms;
+    snapshot_ticks      = snapshot->ticks;
+    counter             = clock_counter();
+    counter_ms          = millis();
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while(generation != clock_generation.load(std::memory_order_relaxed));
+
+  /* Counter ticks since the snapshot plus the whole counter periods millis() says have passed, 
+      rounded to the nearest period as millis() is only accurate to a millisecond */
+  const uint32_t      counter_delta   = (counter - snapshot_counter);
+  const clock_ticks_t ticks_elapsed   = (((clock_ticks_t) (counter_ms - snapshot_counter_ms)) * clock_ticks_per_ms);
+  const clock_ticks_t counter_periods = (ticks_elapsed > counter_delta) ? ((ticks_elapsed - counter_delta + (1ULL << 31)) >> 32) : 0;
+  const clock_ticks_t ticks           = (snapshot_ticks + (counter_periods << 32) + counter_delta);
+
+  /* Publish this reading unless another update is in progress or already published a newer snapshot */
+  if(!clock_updating.exchange(true, std::memory_order_acquire))
+  {
+    if(generation == clock_generation.load(std::memory_order_relaxed))
+    {
+      volatile clock_snapshot_s * const next_snapshot = &clock_snapshots[(generation + 1) & 1];
+      next_snapshot->counter    = counter;
+      next_snapshot->counter_ms = counter_ms;
+      next_snapshot->ticks      = ticks;
+      clock_generation.store(generation + 1, std::memory_order_release);
+    }
+    clock_updating.store(false, std::memory_order_release);
+  }
+
+  return ticks;
+}
+#endif
+
+#if defined(__IMXRT1062__)
+void sandor_laboratories::robot::clock_init()
+{
+  /* Normally already enabled by Teensy startup for micros() */
+  ARM_DEMCR     |= ARM_DEMCR_TRCENA;
+  ARM_DWT_CTRL  |= ARM_DWT_CTRL_CYCCNTENA;
+  clock_ticks_per_ms = (uint32_t) (clock_ticks_per_second() / 1000);
+  clock_us_conversion_init();
+}
+clock_ticks_t sandor_laboratories::robot::clock_ticks_per_second()
+{
+  return F_CPU_ACTUAL;
+}
+#elif defined(__unix__)
+void sandor_laboratories::robot::clock_init()
+{
+  clock_us_conversion_init();
+}
+clock_ticks_t sandor_laboratories::robot::clock_ticks()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((((clock_ticks_t) now.tv_sec) * 1000000000ULL) + now.tv_nsec);
+}
+clock_ticks_t sandor_laboratories::robot::clock_ticks_per_second()
+{
+  return 1000000000ULL;
+}
+#else
+void sandor_laboratories::robot::clock_init()
+{
+  clock_ticks_per_ms = (uint32_t) (clock_ticks_per_second() / 1000);
+  clock_us_conversion_init();
+}
+clock_ticks_t sandor_laboratories::robot::clock_ticks_per_second()
+{
+  return 1000000ULL;
+}
+#endif
@@ -0,0 +1,54 @@
+/*
+  sl_robot_clock.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_ROBOT_CLOCK_HPP__
+#define __SL_ROBOT_CLOCK_HPP__
+
+#include <cstdint>
+
+#include "sl_robot_types.hpp"
+
+namespace sandor_laboratories
+{
+  namespace robot
+  {
+    /* Monotonic clock ticks, 64-bit so they never wrap in practice */
+    typedef uint64_t clock_ticks_t;
+
+    /* High resolution monotonic clock.
+        Teensy 4 (i.MX RT1062): DWT cycle counter (CYCCNT) at the CPU clock, extended to 64 bits in software without locking or masking interrupts.
+          The 32-bit counter wraps every 2^32 cycles (~7.2s at 600MHz).  Each read is cross-checked against millis(), 
+          so wraps missed while the clock was not read are recovered.
+        Linux: clock_gettime(CLOCK_MONOTONIC) in nanoseconds.
+        Other: micros(), extended to 64 bits in software. */
+
+    /* Enables the underlying counter if required.  Reading the clock is valid after this call */
+    void          clock_init();
+    /* Returns current clock ticks, may be called from tasks or interrupts */
+    clock_ticks_t clock_ticks();
+    /* Returns clock tick frequency in Hz */
+    clock_ticks_t clock_ticks_per_second();
+
+    /* Microsecond conversion, us = ((ticks * clock_us_multiplier) >> 32) >> clock_us_shift.  Set from the actual tick frequency by clock_init() */
+    extern uint64_t clock_us_multiplier;
+    extern uint8_t  clock_us_shift;
+    /* Converts clock ticks to microseconds.  Multiplies by the precomputed reciprocal as two 32x32 bit products, 
+        avoiding a 64-bit library division.  Rounding error is below 2^-31 relative, far below oscillator tolerance */
+    inline time_us_t clock_ticks_to_us(clock_ticks_t ticks)
+    {
+      const uint32_t ticks_high = (uint32_t) (ticks >> 32);
+      const uint32_t ticks_low  = (uint32_t) ticks;
+      return (time_us_t) (((ticks_high * clock_us_multiplier) + ((ticks_low * clock_us_multiplier) >> 32)) >> clock_us_shift);
+    }
+    /* Returns current time in microseconds */
+    inline time_us_t clock_us() {return clock_ticks_to_us(clock_ticks());}
+    /* Returns current time in milliseconds */
+    inline time_ms_t clock_ms() {return (time_ms_t) (clock_us() / 1000);}
+  }
+}
+
+#endif /* __SL_ROBOT_CLOCK_HPP__ */
@@ -12,9 +12,11 @@ using namespace sandor_laboratories::robot;
 template <typename SETPOINT_T, typename OUTPUT_T>
 inline void control_loop_c<SETPOINT_T, OUTPUT_T>::set_initial_state()
 {
-  sp     = (sp_min+sp_max)/2;
-  output = (output_min+output_max)/2;
-  error  = 0;
+  sp             = (sp_min+sp_max)/2;
+  output         = (output_min+output_max)/2;
+  error          = 0;
+  last_loop_time = 0;
+  loop_period    = 0;
 }
 
 template <typename SETPOINT_T, typename OUTPUT_T>
@@ -74,10 +76,17 @@ bool control_loop_c<SETPOINT_T, OUTPUT_T>::set_output(OUTPUT_T new_output)
 template <typename SETPOINT_T, typename OUTPUT_T>
 OUTPUT_T control_loop_c<SETPOINT_T, OUTPUT_T>::loop(SETPOINT_T feedback) 
 {
+  const time_us_t loop_time = clock_us();
+  if(last_loop_time)
+  {
+    loop_period = (loop_time - last_loop_time);
+  }
+  last_loop_time = loop_time;
+
   error = (this->get_setpoint() - feedback);
   update_output();
 
-  log_snprintf(get_log_key(), LOG_LEVEL_DEBUG_3, "|%+05d|%+05d|%+05d|", this->get_setpoint(), get_output(), get_error());
+  LOG_BINARY(get_log_key(), LOG_LEVEL_DEBUG_3, "|%+05d|%+05d|%+05d|", this->get_setpoint(), get_output(), get_error());
 
   return get_output();
 }
@@ -8,6 +8,7 @@
 #ifndef __SL_ROBOT_CONTROL_LOOP_HPP__
 #define __SL_ROBOT_CONTROL_LOOP_HPP__
 
+#include "sl_robot_clock.hpp"
 #include "sl_robot_log.hpp"
 #include "sl_robot_types.hpp"
 
@@ -37,6 +38,10 @@ namespace sandor_laboratories
         const OUTPUT_T    output_max;
         const sandor_laboratories::robot::log_key_e log_key;
 
+        /* Loop timing */
+        time_us_t         last_loop_time;
+        time_us_t         loop_period;
+
         void              set_initial_state();
 
       protected:
@@ -63,6 +68,8 @@ namespace sandor_laboratories
         inline OUTPUT_T   get_output()   const {return output;}
         /* Get current error */
         inline SETPOINT_T get_error()    const {return error;}
+        /* Get measured period between the last two loop() calls (us), 0 until loop() has run twice */
+        inline time_us_t  get_loop_period() const {return loop_period;}
         /* Sanitizes and sets new setpoint without running main loop, returns false if out of bounds */
         bool              set_setpoint(SETPOINT_T new_setpoint);
 
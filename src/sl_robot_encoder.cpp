@@ -6,13 +6,17 @@
 */
 
 #include <Arduino.h>
-#include <util/atomic.h>
+#include <climits>
 
+#include "sl_robot_clock.hpp"
 #include "sl_robot_encoder.hpp"
 #include "sl_robot_utils.hpp"
 
 using namespace sandor_laboratories::robot;
 
+/* Counters are updated from interrupts, a lock-based fallback would deadlock */
+static_assert(2 == ATOMIC_INT_LOCK_FREE, "encoder counters require lock-free atomics");
+
 inline void encoder_c::init()
 {
   count                       = 0;
@@ -20,10 +24,21 @@ inline void encoder_c::init()
   skipped_count               = 0;
   count_frequency             = 0;
   rpm                         = 0;
-  last_frequency_update       = millis();
+  position_sequence           = 0;
+  position_base               = 0;
+  last_frequency_update       = clock_us();
   counts_per_revolution       = 1;
   reduction_ratio_numerator   = 1;
   reduction_ratio_denominator = 1;
+  velocity_estimator          = nullptr;
+  rpm_fixed                   = 0;
+  rpm_saturated               = false;
+  period_count_threshold      = 0;
+  period_stop_timeout         = 0;
+  edge_sequence               = 0;
+  edge_index                  = 0;
+  edge_valid                  = 0;
+  edge_direction              = 0;
 }
 
 encoder_c::encoder_c(pin_t ch_a, pin_t ch_b) : 
@@ -35,114 +50,152 @@ encoder_c::encoder_c(pin_t ch_a, pin_t ch_b) :
   pinMode(ch_b_pin, arduino::INPUT);
 
   channel_state = ((digitalReadFast(ch_a_pin) << 1) | digitalReadFast(ch_b_pin));
+
+  update_rpm_multiplier();
 }
 
 encoder_c::encoder_c( pin_t ch_a, pin_t ch_b, 
                                   bool invert_direction, 
                                   encoder_count_t counts_per_revolution, 
                                   reduction_ratio_t reduction_ratio_numerator, 
-                                  reduction_ratio_t reduction_ratio_denominator)
+                                  reduction_ratio_t reduction_ratio_denominator,
+                                  velocity_estimator_c *velocity_estimator)
                                   : encoder_c(ch_a, ch_b)
 {
   this->invert_direction            = invert_direction;
   this->counts_per_revolution       = counts_per_revolution;
   this->reduction_ratio_numerator   = reduction_ratio_numerator;
   this->reduction_ratio_denominator = reduction_ratio_denominator;
+  this->velocity_estimator          = velocity_estimator;
+
+  update_rpm_multiplier();
 }
 
+/* Precomputes RPM multiplier, 60 * numerator / (counts_per_revolution * denominator), 
+    with as many fractional bits as fit in 31 bits */
+void encoder_c::update_rpm_multiplier()
+{
+  ASSERT(counts_per_revolution > 0);
+  ASSERT(reduction_ratio_denominator > 0);
+
+  const uint64_t numerator   = ((uint64_t) 60 * reduction_ratio_numerator);
+  const uint64_t denominator = ((uint64_t) counts_per_revolution * reduction_ratio_denominator);
 
-inline void encoder_c::apply_new_state(encoder_channel_state_t new_channel_state)
+  rpm_multiplier_shift = 32;
+  while((rpm_multiplier_shift > 0) && 
+        ((numerator > (UINT64_MAX >> (rpm_multiplier_shift + 1))) || 
+         (((numerator << rpm_multiplier_shift) / denominator) > INT32_MAX)))
+  {
+    rpm_multiplier_shift--;
+  }
+  /* Round to nearest */
+  rpm_multiplier      = (int64_t) (((numerator << rpm_multiplier_shift) + (denominator / 2)) / denominator);
+  rpm_frequency_limit = (rpm_multiplier > 0) ? (INT64_MAX / rpm_multiplier) : INT64_MAX;
+}
+
+
+/* Unsigned division without a 64-bit divide, which is a library call (__aeabi_uldivmod) on Cortex-M7.
+    The quotient is estimated with a 32-bit reciprocal of the divisor (hardware divide) and corrected with the exact remainder.
+    Divisors of 24 bits or more are scaled down first, relative error below 2^-24.  Saturates at UINT32_MAX */
+static uint32_t encoder_divide(uint64_t numerator, uint64_t divisor)
 {
-  if(channel_state != new_channel_state)
+  uint32_t ret_val = UINT32_MAX;
+
+  while(divisor >= (1UL << 24))
+  {
+    numerator >>= 1;
+    divisor   >>= 1;
+  }
+
+  if(divisor && (numerator < (divisor << 32)))
   {
-    /* Encoder state order:
-        A: _|--|__|--|__|--|_
-        B: __|--|__|--|__|--|
-        0b00->0b10->0b11->0b01->0b00
-    */
-    switch(channel_state)
+    const uint32_t divisor_32 = (uint32_t) divisor;
+    const uint64_t reciprocal = (UINT32_MAX / divisor_32);
+
+    /* Reciprocal is rounded down, so the quotient never overshoots and the remainder stays positive */
+    uint64_t quotient  = ((numerator * reciprocal) >> 32);
+    uint64_t remainder = (numerator - (quotient * divisor_32));
+    while(remainder > UINT32_MAX)
     {
-      case 0b00:
-      {
-        if(0b10 == new_channel_state)
-        {
-          count++;
-        }
-        else if(0b01 == new_channel_state)
-        {
-          count--;
-        }
-        else
-        {
-          skipped_count++;
-        }
-        break;
-      }
-      case 0b10:
-      {
-        if(0b11 == new_channel_state)
-        {
-          count++;
-        }
-        else if(0b00 == new_channel_state)
-        {
-          count--;
-        }
-        else
-        {
-          skipped_count++;
-        }
-        break;
-      }
-      case 0b11:
-      {
-        if(0b01 == new_channel_state)
-        {
-          count++;
-        }
-        else if(0b10 == new_channel_state)
-        {
-          count--;
-        }
-        else
-        {
-          skipped_count++;
-        }
-        break;
-      }
-      case 0b01:
-      {
-        if(0b00 == new_channel_state)
-        {
-          count++;
-        }
-        else if(0b11 == new_channel_state)
-        {
-          count--;
-        }
-        else
-        {
-          skipped_count++;
-        }
-        break;
-      }
-      default:
-      {
-        break;
-      }
+      quotient  += ((remainder * reciprocal) >> 32);
+      remainder  = (numerator - (quotient * divisor_32));
     }
-    channel_state = new_channel_state;
+    ret_val = (uint32_t) (quotient + ((uint32_t) remainder / divisor_32));
+  }
+
+  return ret_val;
+}
+
+
+/* Quadrature transition table, indexed by (old_state << 2) | new_state 
+    Encoder state order:
+      A: _|--|__|--|__|--|_
+      B: __|--|__|--|__|--|
+      0b00->0b10->0b11->0b01->0b00
+    Both channels changing at once is a skipped edge, direction unknown */
+static const encoder_transition_s encoder_transition_table[16] = 
+{
+  /* 0b00 -> */ { 0, 0}, {-1, 0}, { 1, 0}, { 0, 1},
+  /* 0b01 -> */ { 1, 0}, { 0, 0}, { 0, 1}, {-1, 0},
+  /* 0b10 -> */ {-1, 0}, { 0, 1}, { 0, 0}, { 1, 0},
+  /* 0b11 -> */ { 0, 1}, { 1, 0}, {-1, 0}, { 0, 0},
+};
+
+inline void encoder_c::apply_new_state(encoder_channel_state_t new_channel_state)
+{
+  /* Branch-free decode, unchanged state has a delta of 0 */
+  const encoder_channel_state_t old_channel_state = channel_state.load(std::memory_order_relaxed);
+  const encoder_transition_s    transition        = encoder_transition_table[((old_channel_state << 2) | new_channel_state) & 0xF];
+  apply_transition(transition.delta, transition.skipped, new_channel_state);
+}
+/* Applies a decoded transition, called from sampling context */
+void encoder_c::apply_transition(int8_t delta, uint8_t skipped, encoder_channel_state_t new_channel_state)
+{
+  count.fetch_add(delta, std::memory_order_relaxed);
+  if(skipped)
+  {
+    skipped_count.fetch_add(skipped, std::memory_order_relaxed);
+  }
+  channel_state.store(new_channel_state, std::memory_order_relaxed);
+
+  if(period_count_threshold && delta)
+  {
+    record_edge(delta);
+  }
+}
+/* Timestamps a counted edge, called from sampling context */
+inline void encoder_c::record_edge(int8_t direction)
+{
+  const clock_ticks_t edge_time = clock_ticks();
+  const uint32_t      sequence  = edge_sequence.load(std::memory_order_relaxed);
+
+  edge_sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  /* Periods are only valid between edges in the same direction */
+  if(direction != edge_direction)
+  {
+    edge_direction = direction;
+    edge_valid     = 0;
+  }
+  edge_times[edge_index] = edge_time;
+  edge_index             = ((edge_index + 1) < EDGE_TIMES) ? (edge_index + 1) : 0;
+  if(edge_valid < EDGE_TIMES)
+  {
+    edge_valid++;
   }
+
+  edge_sequence.store(sequence + 2, std::memory_order_release);
 }
 void encoder_c::sample_channel_a()
 {
-  encoder_channel_state_t new_channel_state = (channel_state & 0b01);
+  encoder_channel_state_t new_channel_state = (channel_state.load(std::memory_order_relaxed) & 0b01);
   new_channel_state |= (digitalReadFast(ch_a_pin) << 1);
   apply_new_state(new_channel_state);
 }
 void encoder_c::sample_channel_b()
 {
-  encoder_channel_state_t new_channel_state = (channel_state & 0b10);
+  encoder_channel_state_t new_channel_state = (channel_state.load(std::memory_order_relaxed) & 0b10);
   new_channel_state |= digitalReadFast(ch_b_pin);
   apply_new_state(new_channel_state);
 }
@@ -151,63 +204,193 @@ void encoder_c::sample_channels()
   encoder_channel_state_t new_channel_state = ((digitalReadFast(ch_a_pin) << 1) | digitalReadFast(ch_b_pin));
   apply_new_state(new_channel_state);
 }
+void encoder_c::sample_state(encoder_channel_state_t new_channel_state)
+{
+  apply_new_state(new_channel_state & 0b11);
+}
+
+void encoder_c::set_period_estimation(encoder_count_t window_count_threshold, time_us_t stop_timeout)
+{
+  critical_section_enter();
+  period_stop_timeout    = (stop_timeout * (clock_ticks_per_second() / 1000000));
+  period_count_threshold = window_count_threshold;
+  edge_valid             = 0;
+  critical_section_exit();
+}
 
 inline void encoder_c::compute_rotation_frequency()
 {
-  const time_ms_t    snapshot_time = millis();
+  clock_ticks_t newest_edge_time = 0;
+  clock_ticks_t oldest_edge_time = 0;
+  uint8_t       edges            = 0;
+  int8_t        direction        = 0;
 
-  /* Only update if millis has incremented to avoid divide by 0 */
+  if(period_count_threshold)
+  {
+    /* Retry if an edge was recorded during the snapshot */
+    uint32_t edge_snapshot_sequence;
+    do
+    {
+      edge_snapshot_sequence = edge_sequence.load(std::memory_order_acquire);
+      edges                  = edge_valid;
+      direction              = edge_direction;
+      newest_edge_time       = edge_times[(edge_index + EDGE_TIMES - 1) % EDGE_TIMES];
+      oldest_edge_time       = edge_times[(edge_index + EDGE_TIMES - edges) % EDGE_TIMES];
+      std::atomic_thread_fence(std::memory_order_acquire);
+    } while((edge_snapshot_sequence & 1) || (edge_snapshot_sequence != edge_sequence.load(std::memory_order_relaxed)));
+  }
+
+  /* Clock is read after the edge snapshot, so no snapshotted edge is newer than snapshot_ticks */
+  const clock_ticks_t snapshot_ticks = clock_ticks();
+  const time_us_t     snapshot_time  = clock_ticks_to_us(snapshot_ticks);
+
+  /* Only update if clock has incremented to avoid divide by 0 */
   if(snapshot_time > last_frequency_update)
   {
-    /* Atomically take snapshot of count and reset counter */
-    critical_section_enter();
-    last_count = count;
-    count = 0;
-    critical_section_exit();
+    const int64_t elapsed_time = (int64_t) (snapshot_time-last_frequency_update);
+
+    /* Atomically take snapshot of count and reset counter, counts arriving after the exchange go to the next window.
+        Counts move to the absolute position in the same update, so position readers never see them missing */
+    const uint32_t position_update_sequence = position_sequence.load(std::memory_order_relaxed);
+    position_sequence.store(position_update_sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    last_count     = count.exchange(0, std::memory_order_relaxed);
+    position_base  = (position_base + last_count);
+    position_sequence.store(position_update_sequence + 2, std::memory_order_release);
 
     if(invert_direction)
     {
       last_count = (-last_count);
+      direction  = (-direction);
+    }
+
+    if(period_count_threshold && (abs(last_count) < period_count_threshold) && (edges >= 2))
+    {
+      /* Low speed - mean period of the last edges.  
+          Time since the last edge bounds the period from below, so a slowing encoder decays towards 0.
+          The mean is taken as (edges - 1) periods over their span, so no division by the edge count is needed */
+      const clock_ticks_t since_last_edge = (snapshot_ticks - newest_edge_time);
+      uint64_t            periods         = (edges - 1);
+      clock_ticks_t       span            = (newest_edge_time - oldest_edge_time);
+      if((since_last_edge * periods) > span)
+      {
+        periods = 1;
+        span    = since_last_edge;
+      }
+
+      if((since_last_edge >= period_stop_timeout) || (0 == span))
+      {
+        compute_rpm(0);
+      }
+      else
+      {
+        const uint64_t ticks_per_second = clock_ticks_per_second();
+        compute_rpm(direction * (int64_t) encoder_divide(ticks_per_second * periods * (1 << RPM_FIXED_FRACTION_BITS), span));
+      }
+    }
+    else
+    {
+      const uint64_t frequency_fixed = encoder_divide((uint64_t) abs(last_count) * 1000000 * (1 << RPM_FIXED_FRACTION_BITS), 
+                                                      (uint64_t) elapsed_time);
+      compute_rpm((last_count < 0) ? -(int64_t) frequency_fixed : (int64_t) frequency_fixed);
+    }
+
+    if(velocity_estimator)
+    {
+      velocity_estimator->update(rpm_fixed, (time_us_t) elapsed_time);
     }
-    count_frequency = (last_count * 1000) / 
-                      ((encoder_frequency_t) (snapshot_time-last_frequency_update));
-     rpm            = ((rpm_t)(last_count * 1000 * 60 * reduction_ratio_numerator)) / 
-                      ((rpm_t)((snapshot_time-last_frequency_update) * counts_per_revolution * reduction_ratio_denominator));
- 
+
     last_frequency_update = snapshot_time;
   }
 }
 
-encoder_count_t encoder_c::get_count() const 
+/* Converts count frequency (counts per second, RPM_FIXED_FRACTION_BITS fractional bits) to RPM with the precomputed multiplier */
+inline void encoder_c::compute_rpm(int64_t frequency_fixed)
 {
-  encoder_count_t saved_count;
-  critical_section_enter();
-  saved_count = count;
-  critical_section_exit();
+  int64_t rpm_fixed_wide;
 
-  return saved_count;
+  if((frequency_fixed > rpm_frequency_limit) || (frequency_fixed < -rpm_frequency_limit))
+  {
+    rpm_fixed_wide = (frequency_fixed > 0) ? INT64_MAX : INT64_MIN;
+  }
+  else
+  {
+    /* Arithmetic shift rounds towards negative infinity, so shift the magnitude to keep results symmetric */
+    const int64_t magnitude = (((frequency_fixed < 0) ? -frequency_fixed : frequency_fixed) * rpm_multiplier) >> rpm_multiplier_shift;
+    rpm_fixed_wide = (frequency_fixed < 0) ? -magnitude : magnitude;
+  }
+
+  rpm_saturated = ((rpm_fixed_wide > INT32_MAX) || (rpm_fixed_wide < -INT32_MAX));
+  rpm_fixed     = rpm_saturated ? ((rpm_fixed_wide > 0) ? INT32_MAX : -INT32_MAX) : (rpm_fixed_t) rpm_fixed_wide;
+
+  count_frequency = (encoder_frequency_t) (frequency_fixed / (1 << RPM_FIXED_FRACTION_BITS));
+  rpm             = (rpm_t) (rpm_fixed / (1 << RPM_FIXED_FRACTION_BITS));
+}
+
+encoder_count_t encoder_c::get_count() const 
+{
+  return count.load(std::memory_order_relaxed);
 };
 encoder_count_t encoder_c::get_skipped_count() const 
 {
-  encoder_count_t saved_skipped_count;
-
-  critical_section_enter();
-  saved_skipped_count = skipped_count;
-  critical_section_exit();
-
-  return saved_skipped_count;
+  return skipped_count.load(std::memory_order_relaxed);
 };
 encoder_channel_state_t encoder_c::get_state() const
 {
-  encoder_channel_state_t saved_channel_state;
-
-  critical_section_enter();
-  saved_channel_state = channel_state;
-  critical_section_exit();
-  
-  return saved_channel_state;
+  return channel_state.load(std::memory_order_relaxed);
 };
 
+encoder_position_t encoder_c::get_position() const
+{
+  encoder_position_t position;
+  uint32_t           position_snapshot_sequence;
+
+  /* An interrupt would spin forever on an update it preempted */
+  ASSERT(!interrupt_context());
+
+  /* Retry if loop() moved counts to position_base during the snapshot */
+  do
+  {
+    position_snapshot_sequence = position_sequence.load(std::memory_order_acquire);
+    if(position_snapshot_sequence & 1)
+    {
+      /* An update is in progress in a preempted task, which may be of lower priority and never run while this task spins.
+          Block so it can finish, outside the scheduler nothing can preempt the update */
+      if(task_context())
+      {
+        task_sleep();
+      }
+      continue;
+    }
+    position = (position_base + count.load(std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while((position_snapshot_sequence & 1) || (position_snapshot_sequence != position_sequence.load(std::memory_order_relaxed)));
+
+  return invert_direction ? (-position) : position;
+}
+double encoder_c::get_position_revolutions() const
+{
+  return (((double) get_position() * reduction_ratio_numerator) / 
+          ((double) counts_per_revolution * reduction_ratio_denominator));
+}
+encoder_position_t encoder_c::reset_position(encoder_position_t new_position)
+{
+  const encoder_position_t raw_position             = invert_direction ? (-new_position) : new_position;
+  const uint32_t           position_update_sequence = position_sequence.load(std::memory_order_relaxed);
+
+  position_sequence.store(position_update_sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  /* Single read of count, counts after it belong to the new position */
+  const encoder_count_t    window_count = count.load(std::memory_order_relaxed);
+  const encoder_position_t old_position = (position_base + window_count);
+  position_base = (raw_position - window_count);
+
+  position_sequence.store(position_update_sequence + 2, std::memory_order_release);
+
+  return invert_direction ? (-old_position) : old_position;
+}
+
 
 void encoder_c::loop()
 {
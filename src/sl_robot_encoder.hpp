@@ -8,7 +8,11 @@
 #ifndef __SL_ROBOT_ENCODER_HPP__
 #define __SL_ROBOT_ENCODER_HPP__
 
+#include <atomic>
+
+#include "sl_robot_clock.hpp"
 #include "sl_robot_types.hpp"
+#include "sl_robot_velocity_estimator.hpp"
 
 namespace sandor_laboratories
 {
@@ -16,6 +20,8 @@ namespace sandor_laboratories
   {
     /* Encoder Count Type */
     typedef int encoder_count_t;
+    /* Encoder Absolute Position Type (in counts) */
+    typedef int64_t encoder_position_t;
     /* Encoder Frequency Type 
       (in counts per second, negative corresponds to reverse direction) */
     typedef int encoder_frequency_t;
@@ -23,23 +29,58 @@ namespace sandor_laboratories
     typedef unsigned int reduction_ratio_t;
     /* Encoder Channel State Type */
     typedef unsigned int encoder_channel_state_t;
+    /* Quadrature state transition, packed so the count delta and skipped flag are one load */
+    typedef struct __attribute__((packed, aligned(2)))
+    {
+      int8_t  delta;
+      uint8_t skipped;
+    } encoder_transition_s;
+
+    class encoder_bank_c;
 
     class encoder_c
     {
+      /* Banks decode transitions for many encoders and apply them with apply_transition() */
+      friend class encoder_bank_c;
+
       private:
+        /* Edge timestamps kept for period-based estimation, 4 intervals spanning one full quadrature cycle 
+            so channel phase and duty cycle errors average out */
+        static constexpr uint8_t EDGE_TIMES = 5;
+
         /* Pin Assignments */
         const pin_t                      ch_a_pin;
         const pin_t                      ch_b_pin;
 
-        /* State Information */
-        volatile encoder_channel_state_t channel_state;
-        volatile encoder_count_t         count;
-        volatile encoder_count_t         skipped_count;
+        /* State Information 
+            Written from sampling (interrupt) context with atomic read-modify-write, 
+              so they are read without disabling interrupts */
+        std::atomic<encoder_channel_state_t> channel_state;
+        std::atomic<encoder_count_t>         count;
+        std::atomic<encoder_count_t>         skipped_count;
         encoder_count_t                  last_count;
-        time_ms_t                           last_frequency_update;
+        time_us_t                        last_frequency_update;
         encoder_frequency_t              count_frequency;
         rpm_t                            rpm;
 
+        /* Absolute Position
+            Counts taken from the window by loop() are added to position_base, so position is position_base + count.
+            Guarded by a sequence lock, odd while loop() or reset_position() is updating */
+        std::atomic<uint32_t>            position_sequence;
+        volatile encoder_position_t      position_base;
+
+        /* Edge Timing (period-based estimation) 
+            64-bit times cannot be written atomically, so edge data is guarded by a sequence lock:
+              odd while the sampling context is writing, readers retry until they see the same even value */
+        encoder_count_t                  period_count_threshold;
+        clock_ticks_t                    period_stop_timeout;
+        std::atomic<uint32_t>            edge_sequence;
+        volatile clock_ticks_t           edge_times[EDGE_TIMES];
+        volatile uint8_t                 edge_index;
+        /* Consecutive edges in edge_direction recorded, up to EDGE_TIMES */
+        volatile uint8_t                 edge_valid;
+        volatile int8_t                  edge_direction;
+
         /* RPM Configuration */
         bool                                  invert_direction;
         /* Counts per encoder revolution - total of rising and falling edges of both channels
@@ -50,9 +91,24 @@ namespace sandor_laboratories
         /* Reduction ratio to account for gearing-type reductions */
         reduction_ratio_t               reduction_ratio_numerator;
         reduction_ratio_t               reduction_ratio_denominator;
+        /* Count frequency (counts per second, fixed point) to RPM (fixed point) multiplier, precomputed from the RPM configuration:
+            rpm_fixed = (frequency_fixed * rpm_multiplier) >> rpm_multiplier_shift */
+        int64_t                         rpm_multiplier;
+        unsigned int                    rpm_multiplier_shift;
+        /* Largest fixed point frequency magnitude which may be multiplied without overflow */
+        int64_t                         rpm_frequency_limit;
+        rpm_fixed_t                     rpm_fixed;
+        bool                            rpm_saturated;
+
+        /* Optional filter applied to raw RPM, not owned */
+        velocity_estimator_c           *velocity_estimator;
 
         void apply_new_state(encoder_channel_state_t);
+        void apply_transition(int8_t delta, uint8_t skipped, encoder_channel_state_t new_channel_state);
+        void record_edge(int8_t direction);
         void compute_rotation_frequency();
+        void compute_rpm(int64_t frequency_fixed);
+        void update_rpm_multiplier();
 
         void init();
 
@@ -65,7 +121,8 @@ namespace sandor_laboratories
                         bool invert_direction, 
                         encoder_count_t counts_per_revolution         = 1, 
                         reduction_ratio_t reduction_ratio_numerator   = 1, 
-                        reduction_ratio_t reduction_ratio_denominator = 1);
+                        reduction_ratio_t reduction_ratio_denominator = 1,
+                        velocity_estimator_c *velocity_estimator      = nullptr);
         
         /* Functions to sample encoder channels.  
           These functions should be called in the appropriate pin interrupt 
@@ -73,20 +130,48 @@ namespace sandor_laboratories
         void sample_channel_a();
         void sample_channel_b();
         void sample_channels();
+        /* Applies a channel state read elsewhere, such as from a port expander or a simulated waveform.
+            State is (channel A << 1) | channel B */
+        void sample_state(encoder_channel_state_t new_channel_state);
+
+        /* Enables period-based estimation for low speeds.
+            Each counted edge is timestamped in the sampling functions and, while fewer than window_count_threshold counts
+              occur between loop() calls, rotation frequency is taken from the period between the last edges instead.
+            Frequency reads 0 once no edge has occurred for stop_timeout (us).
+            A window_count_threshold of 0 disables period-based estimation (default) */
+        void set_period_estimation(encoder_count_t window_count_threshold, time_us_t stop_timeout = 100000);
 
         /* Main loop for encoder
             This function is to be called periodically to compute rotation frequency and perform other maintenance 
-            Recommended to call < 1ms (millis() resolution).  less frequent will average better, but have greater latency */
+            Timed with the microsecond clock (sl_robot_clock.hpp), so it may be called well above 1kHz.  
+            Less frequent will average better, but have greater latency */
         void loop();
 
-        /* Get Encoder Measurements */
-        rpm_t                   get_rpm()             const {return rpm;};
+        /* Get Encoder Measurements 
+            RPM and acceleration are filtered by the velocity estimator if one was given, otherwise acceleration is 0 */
+        rpm_t                   get_rpm()             const {return velocity_estimator ? velocity_estimator->get_rpm() : rpm;};
+        rpm_acceleration_t      get_acceleration()    const {return velocity_estimator ? velocity_estimator->get_acceleration() : 0;};
+        rpm_t                   get_raw_rpm()         const {return rpm;};
+        /* Raw RPM with RPM_FIXED_FRACTION_BITS fractional bits, for control loops needing sub-RPM resolution */
+        rpm_fixed_t             get_rpm_fixed()       const {return rpm_fixed;};
+        /* Returns 'true' if the last raw RPM exceeded the fixed point range and was clamped */
+        bool                    is_rpm_saturated()    const {return rpm_saturated;};
         encoder_frequency_t     get_count_frequency() const {return count_frequency;};
         encoder_count_t         get_last_count()      const {return last_count;};
-        /* Get Raw Encoder Values, not recommended as these requires atomic operations */
+        /* Get Raw Encoder Values, lock-free snapshots of values changing in sampling context */
         encoder_count_t         get_count()           const;
         encoder_count_t         get_skipped_count()   const;
         encoder_channel_state_t get_state()           const;
+
+        /* Absolute position in counts, 64-bit so it never wraps.  Must not be called from interrupts.
+            Lock-free unless it preempts loop() or reset_position() mid-update, then it sleeps a tick so they finish
+              even from a lower priority task */
+        encoder_position_t      get_position()        const;
+        /* Absolute position in output revolutions, applying counts per revolution and reduction ratio */
+        double                  get_position_revolutions() const;
+        /* Atomically sets absolute position, returning the position it replaced.  
+            Must be called from the task calling loop() */
+        encoder_position_t      reset_position(encoder_position_t new_position = 0);
     };
   }
 }
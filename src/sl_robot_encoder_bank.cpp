@@ -0,0 +1,134 @@
+/*
+  sl_robot_encoder_bank.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <Arduino.h>
+
+#include "sl_robot_encoder_bank.hpp"
+#include "sl_robot_utils.hpp"
+
+using namespace sandor_laboratories::robot;
+
+encoder_bank_c::encoder_bank_c(const volatile encoder_port_t *port_register)
+  : port(port_register), encoder_count(0), aligned(true), ch_b_offset(0), ch_a_mask(0), last_a(0), last_b(0)
+{
+  for(size_t i = 0; i < LANES; i++)
+  {
+    lane_encoders[i] = nullptr;
+  }
+}
+
+bool encoder_bank_c::add(encoder_c *encoder, uint8_t ch_a_bit, uint8_t ch_b_bit)
+{
+  bool ret_val = (encoder && (encoder_count < ENCODERS_MAX) && 
+                  (ch_a_bit < LANES) && (ch_b_bit < LANES) && (ch_a_bit != ch_b_bit));
+
+  for(size_t i = 0; ret_val && (i < encoder_count); i++)
+  {
+    ret_val = ((ch_a_bits[i] != ch_a_bit) && (ch_a_bits[i] != ch_b_bit) && 
+               (ch_b_bits[i] != ch_a_bit) && (ch_b_bits[i] != ch_b_bit));
+  }
+
+  if(ret_val)
+  {
+    critical_section_enter();
+    encoders[encoder_count]  = encoder;
+    ch_a_bits[encoder_count] = ch_a_bit;
+    ch_b_bits[encoder_count] = ch_b_bit;
+    encoder_count++;
+    update_lanes();
+    critical_section_exit();
+  }
+
+  return ret_val;
+}
+
+/* Rebuilds lane layout and last channel states from registered encoders */
+void encoder_bank_c::update_lanes()
+{
+  ch_b_offset = ((int) ch_b_bits[0] - (int) ch_a_bits[0]);
+  aligned     = true;
+  for(size_t i = 1; i < encoder_count; i++)
+  {
+    aligned = (aligned && (((int) ch_b_bits[i] - (int) ch_a_bits[i]) == ch_b_offset));
+  }
+
+  ch_a_mask = 0;
+  last_a    = 0;
+  last_b    = 0;
+  for(size_t i = 0; i < LANES; i++)
+  {
+    lane_encoders[i] = nullptr;
+  }
+  for(size_t i = 0; i < encoder_count; i++)
+  {
+    const size_t                  lane  = aligned ? ch_a_bits[i] : i;
+    const encoder_channel_state_t state = encoders[i]->get_state();
+
+    ch_a_mask          |= ((encoder_port_t) 1 << ch_a_bits[i]);
+    lane_encoders[lane] = encoders[i];
+    last_a             |= ((encoder_port_t) ((state >> 1) & 1) << lane);
+    last_b             |= ((encoder_port_t) (state & 1) << lane);
+  }
+}
+
+/* Extracts channel A and B lanes from a port snapshot */
+inline void encoder_bank_c::gather(encoder_port_t port_state, encoder_port_t *a, encoder_port_t *b) const
+{
+  if(aligned)
+  {
+    *a = (port_state & ch_a_mask);
+    *b = (((ch_b_offset >= 0) ? (port_state >> ch_b_offset) : (port_state << -ch_b_offset)) & ch_a_mask);
+  }
+  else
+  {
+    *a = 0;
+    *b = 0;
+    for(size_t i = 0; i < encoder_count; i++)
+    {
+      *a |= (((port_state >> ch_a_bits[i]) & 1) << i);
+      *b |= (((port_state >> ch_b_bits[i]) & 1) << i);
+    }
+  }
+}
+
+void encoder_bank_c::sample()
+{
+  ASSERT(port);
+  sample(*port);
+}
+void encoder_bank_c::sample(encoder_port_t port_state)
+{
+  encoder_port_t a, b;
+  gather(port_state, &a, &b);
+
+  /* Encoder state order (A is the high bit):
+      0b00->0b10->0b11->0b01->0b00
+    One channel changing is a count.  Moving forward, A changes to differ from B and B changes to match A,
+      so the count is backward when the changed channel disagrees with that.
+    Both channels changing is a skipped edge */
+  const encoder_port_t changed_a = (a ^ last_a);
+  const encoder_port_t changed_b = (b ^ last_b);
+  const encoder_port_t single    = (changed_a ^ changed_b);
+  const encoder_port_t skipped   = (changed_a & changed_b);
+  const encoder_port_t backward  = (single & (changed_a ^ a ^ b));
+  const encoder_port_t forward   = (single & ~backward);
+
+  last_a = a;
+  last_b = b;
+
+  /* Visit changed lanes only */
+  encoder_port_t changed = (changed_a | changed_b);
+  while(changed)
+  {
+    const unsigned int lane = __builtin_ctz(changed);
+    changed &= (changed - 1);
+
+    lane_encoders[lane]->apply_transition((int8_t) (((forward >> lane) & 1) - ((backward >> lane) & 1)),
+                                          (uint8_t) ((skipped >> lane) & 1),
+                                          (encoder_channel_state_t) ((((a >> lane) & 1) << 1) | ((b >> lane) & 1)));
+  }
+}
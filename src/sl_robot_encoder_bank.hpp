@@ -0,0 +1,80 @@
+/*
+  sl_robot_encoder_bank.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_ROBOT_ENCODER_BANK_HPP__
+#define __SL_ROBOT_ENCODER_BANK_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sl_robot_encoder.hpp"
+
+namespace sandor_laboratories
+{
+  namespace robot
+  {
+    /* GPIO Port Word Type */
+    typedef uint32_t encoder_port_t;
+
+    /* Decodes many encoders wired to one GPIO port from a single port snapshot.
+        Channels of every encoder are gathered into lanes (one bit per encoder) and all lanes are decoded at once with bitwise 
+          operations.  Only encoders with a changed channel are visited, where counts are applied to the registered encoder_c, 
+          so get_rpm() and the other encoder_c measurements work unchanged.
+        If every encoder has the same channel B to channel A bit offset, lanes are the channel A bits of the port word and
+          no gathering is needed.
+        Registered encoders must not also be sampled with their own sample_channel functions.
+        A bank holds at most ENCODERS_MAX (16) encoders, as each uses two bits of the 32-bit port word.
+          17 to 32 encoders need multiple banks, one per GPIO port, each sampled from its own port snapshot. */
+    class encoder_bank_c
+    {
+      public:
+        /* Each encoder uses two port bits */
+        static constexpr size_t ENCODERS_MAX = ((sizeof(encoder_port_t) * 8) / 2);
+
+      private:
+        static constexpr size_t LANES = (sizeof(encoder_port_t) * 8);
+
+        /* Port input register, may be null if snapshots are passed to sample() */
+        const volatile encoder_port_t *port;
+
+        /* Registered encoders */
+        encoder_c     *encoders[ENCODERS_MAX];
+        uint8_t        ch_a_bits[ENCODERS_MAX];
+        uint8_t        ch_b_bits[ENCODERS_MAX];
+        size_t         encoder_count;
+
+        /* Lane layout */
+        bool           aligned;
+        int            ch_b_offset;
+        encoder_port_t ch_a_mask;
+        encoder_c     *lane_encoders[LANES];
+
+        /* Channel states of the last snapshot, one bit per lane */
+        encoder_port_t last_a;
+        encoder_port_t last_b;
+
+        void           update_lanes();
+        inline void    gather(encoder_port_t port_state, encoder_port_t *a, encoder_port_t *b) const;
+
+      public:
+        encoder_bank_c(const volatile encoder_port_t *port_register = nullptr);
+
+        /* Registers an encoder with its channel A and B bit positions in the port word.  
+            Returns 'false' if the bank is full or a bit is already used */
+        bool add(encoder_c *encoder, uint8_t ch_a_bit, uint8_t ch_b_bit);
+
+        /* Functions to sample the port.
+          These functions should be called in the port interrupt or sampled at a sufficient frequency for the encoders' max RPM */
+        void sample();
+        void sample(encoder_port_t port_state);
+
+        inline size_t size() const {return encoder_count;}
+    };
+  }
+}
+
+#endif // __SL_ROBOT_ENCODER_BANK_HPP__
@@ -7,100 +7,551 @@
 */
 
 #include <Arduino.h>
+#include <atomic>
 
-#include "sl_robot_circular_buffer.hpp"
+#include "sl_robot_circular_buffer_record.hpp"
+#include "sl_robot_clock.hpp"
 #include "sl_robot_log.hpp"
+#include "sl_robot_log_sink.hpp"
 #include "sl_robot_log_task.hpp"
 
 using namespace sandor_laboratories::robot;
 
-#define LOG_BUFFER_ENTRIES 16
-#define LOG_HDR_STRING_FORMAT "[0x%02x|0x%01x|0x%06lx] "
+/* Shared log buffer size in bytes, must be a power of 2.  Used by interrupts and tasks without a task log buffer */
+#define LOG_BUFFER_SIZE (16*sizeof(log_entry_s))
+/* Task log buffers, allocated by log_init() (LOG_TASK_BUFFERS_MAX * LOG_TASK_BUFFER_SIZE, 8KB, up front).  
+    Each task claims its own single producer buffer on its first log entry and releases it with log_task_unregister() */
+#define LOG_TASK_BUFFERS_MAX 8
+#define LOG_TASK_BUFFER_SIZE (8*sizeof(log_entry_s))
+/* Thread local storage pointer index holding each task's log buffer.  
+    Defaults to the last index, applications and other libraries conventionally start from 0 */
+#ifndef SL_ROBOT_LOG_TLS_INDEX
+#define SL_ROBOT_LOG_TLS_INDEX (configNUM_THREAD_LOCAL_STORAGE_POINTERS-1)
+#endif
+static_assert((SL_ROBOT_LOG_TLS_INDEX >= 0) && (SL_ROBOT_LOG_TLS_INDEX < configNUM_THREAD_LOCAL_STORAGE_POINTERS), 
+              "log thread local storage index out of range, requires configNUM_THREAD_LOCAL_STORAGE_POINTERS >= 1");
+/* Maximum length entries kept free in every log buffer for ERROR and WARNING entries, so lower levels cannot drop faults */
+#ifndef SL_ROBOT_LOG_RESERVED_ENTRIES
+#define SL_ROBOT_LOG_RESERVED_ENTRIES 2
+#endif
+/* Sized from the worst case record footprint, header and alignment included, plus one maximum length wrap padding */
+#define LOG_RESERVE_SIZE ((SL_ROBOT_LOG_RESERVED_ENTRIES+1)*circular_buffer_record_c::record_size(sizeof(log_entry_s)))
+static_assert(LOG_RESERVE_SIZE < LOG_TASK_BUFFER_SIZE, "log reserve exceeds task log buffer");
+#define LOG_HDR_STRING_FORMAT "[0x%02x|0x%01x|0x%08lx] "
+/* Formatted text buffered per sink batch, a batch is written early if another maximum length line may not fit */
+#define LOG_FLUSH_TEXT_SIZE 1024
 
 const TaskHandle_t * log_task_h_ptr;
-circular_buffer_c<log_entry_s> *log_buffer;
-log_level_e active_log_level = LOG_LEVEL_ALL;
+circular_buffer_record_c *log_buffer;
+typedef enum : uint8_t
+{
+  LOG_TASK_BUFFER_FREE,
+  LOG_TASK_BUFFER_CLAIMED,
+  /* Released by its task, becomes free once log_flush() has emptied it */
+  LOG_TASK_BUFFER_RELEASED,
+} log_task_buffer_state_e;
+circular_buffer_record_c               *log_task_buffers[LOG_TASK_BUFFERS_MAX];
+std::atomic<log_task_buffer_state_e>    log_task_buffer_states[LOG_TASK_BUFFERS_MAX];
+log_sink_serial_c         log_serial_sink(Serial);
+log_sink_c               *log_sink = &log_serial_sink;
 
-typedef unsigned int failed_log_allocations_t;
-volatile failed_log_allocations_t failed_log_allocations;
+/* Batch being built by log_flush() */
+log_sink_record_s log_batch_records[SL_ROBOT_LOG_SINK_BATCH_RECORDS];
+char              log_batch_text[LOG_FLUSH_TEXT_SIZE];
+log_sink_batch_s  log_batch = {log_batch_records, 0, log_batch_text, 0};
+/* Per key runtime log levels, read without locking by any producer */
+std::atomic<log_level_e> active_log_levels[LOG_KEY_MAX];
 
-inline failed_log_allocations_t get_and_clear_failed_log_allocations()
-{
-  failed_log_allocations_t ret_val;
+/* Dropped log entry counts, never cleared so they can be read by diagnostics.  log_flush() reports changes since its last call */
+std::atomic<log_drop_count_t> log_drops_full;
+std::atomic<log_drop_count_t> log_drops_rate_limited;
+std::atomic<log_drop_count_t> log_drops_level[LOG_LEVEL_ALL+1];
+std::atomic<log_drop_count_t> log_drops_key[LOG_KEY_MAX];
+log_drop_counts_s             log_drops_reported;
 
-  critical_section_enter();
-  ret_val = failed_log_allocations;
-  failed_log_allocations = 0;
-  critical_section_exit();
+/* Time of the last time sync entry, only used by log_flush().  Synced on the first flush after log_init() */
+time_us_t                     log_time_sync_last;
+bool                          log_time_sync_pending;
 
-  return ret_val;
+/* Token bucket per key.  Tokens are stored in thousandths so refills at 1ms resolution are exact */
+#define LOG_RATE_LIMIT_TOKEN_SCALE 1000
+typedef struct
+{
+  std::atomic<log_rate_t>      rate;
+  std::atomic<uint32_t>        burst_tokens;
+  std::atomic<uint32_t>        tokens;
+  /* Time in ms */
+  std::atomic<uint32_t>        last_refill;
+} log_rate_limit_s;
+log_rate_limit_s log_rate_limits[LOG_KEY_MAX];
+
+/* Counts a dropped log entry for reason, key and level */
+static inline void log_drop(std::atomic<log_drop_count_t> & reason, log_key_e key, log_level_e level)
+{
+  reason.fetch_add(1, std::memory_order_relaxed);
+  log_drops_key[key].fetch_add(1, std::memory_order_relaxed);
+  log_drops_level[level].fetch_add(1, std::memory_order_relaxed);
 }
 
 inline log_timestamp_t get_timestamp()
 {
-  return millis();
+  return (log_timestamp_t) clock_us();
+}
+/* Returns 'true' if log timestamp a is before b, accounting for timestamp wrap */
+static inline bool log_timestamp_before(log_timestamp_t a, log_timestamp_t b)
+{
+  return (((int32_t) (a - b)) < 0);
+}
+
+/* Claims a free task log buffer for the calling task.  Falls back to the shared log buffer while all task log buffers are claimed */
+static circular_buffer_record_c * log_task_buffer_register()
+{
+  circular_buffer_record_c * buffer = log_buffer;
+
+  for(unsigned int i = 0; i < LOG_TASK_BUFFERS_MAX; i++)
+  {
+    log_task_buffer_state_e state = LOG_TASK_BUFFER_FREE;
+    if(log_task_buffer_states[i].compare_exchange_strong(state, LOG_TASK_BUFFER_CLAIMED, std::memory_order_acquire))
+    {
+      buffer = log_task_buffers[i];
+      break;
+    }
+  }
+  task_local_storage_set(SL_ROBOT_LOG_TLS_INDEX, buffer);
+
+  return buffer;
+}
+/* Returns log buffer for the caller, the calling task's own buffer or the shared buffer from interrupts */
+static circular_buffer_record_c * log_producer_buffer()
+{
+  circular_buffer_record_c * buffer = log_buffer;
+
+  if(task_context())
+  {
+    buffer = (circular_buffer_record_c *) task_local_storage_get(SL_ROBOT_LOG_TLS_INDEX);
+    if(nullptr == buffer)
+    {
+      buffer = log_task_buffer_register();
+    }
+  }
+
+  return buffer;
+}
+
+/* Takes one token from key's bucket.  Returns 'true' if entry may be logged */
+static bool log_rate_limit_take(log_key_e key)
+{
+  log_rate_limit_s * const bucket = &log_rate_limits[key];
+  const log_rate_t         rate   = bucket->rate.load(std::memory_order_relaxed);
+  bool                     ret_val = true;
+
+  if(rate)
+  {
+    const uint32_t  burst_tokens = bucket->burst_tokens.load(std::memory_order_relaxed);
+    const uint32_t  now          = (uint32_t) clock_ms();
+    uint32_t        last_refill  = bucket->last_refill.load(std::memory_order_relaxed);
+
+    /* Only the producer that advances last_refill adds the elapsed tokens */
+    if((now != last_refill) && 
+       bucket->last_refill.compare_exchange_strong(last_refill, now, std::memory_order_relaxed))
+    {
+      /* Refill in 64 bits and cap at the burst capacity, so any elapsed time can fill any bucket without overflow */
+      const uint64_t        elapsed = (now - last_refill);
+      const uint64_t        refill  = (elapsed * rate);
+      uint32_t              tokens  = bucket->tokens.load(std::memory_order_relaxed);
+      uint32_t              new_tokens;
+      do
+      {
+        new_tokens = ((tokens + refill) > burst_tokens) ? burst_tokens : (uint32_t) (tokens + refill);
+      } while(!bucket->tokens.compare_exchange_weak(tokens, new_tokens, std::memory_order_relaxed));
+    }
+
+    uint32_t tokens = bucket->tokens.load(std::memory_order_relaxed);
+    do
+    {
+      if(tokens < LOG_RATE_LIMIT_TOKEN_SCALE)
+      {
+        ret_val = false;
+        break;
+      }
+    } while(!bucket->tokens.compare_exchange_weak(tokens, (tokens - LOG_RATE_LIMIT_TOKEN_SCALE), std::memory_order_relaxed));
+  }
+
+  return ret_val;
 }
 
 void sandor_laboratories::robot::change_log_level(log_level_e new_log_level)
 {
-  critical_section_enter();
-  active_log_level = new_log_level;
-  critical_section_exit();
+  for(unsigned int key = 0; key < LOG_KEY_MAX; key++)
+  {
+    active_log_levels[key].store(new_log_level, std::memory_order_relaxed);
+  }
+}
+void sandor_laboratories::robot::change_log_level(log_key_e key, log_level_e new_log_level)
+{
+  ASSERT(key < LOG_KEY_MAX);
+  active_log_levels[key].store(new_log_level, std::memory_order_relaxed);
+}
+
+void sandor_laboratories::robot::log_rate_limit(log_key_e key, log_rate_t rate, log_rate_t burst)
+{
+  ASSERT(key < LOG_KEY_MAX);
+  /* Disable while reconfiguring so producers do not see a partial configuration */
+  log_rate_limits[key].rate.store(0, std::memory_order_relaxed);
+  log_rate_limits[key].burst_tokens.store((burst * LOG_RATE_LIMIT_TOKEN_SCALE), std::memory_order_relaxed);
+  log_rate_limits[key].tokens.store((burst * LOG_RATE_LIMIT_TOKEN_SCALE), std::memory_order_relaxed);
+  log_rate_limits[key].last_refill.store((uint32_t) clock_ms(), std::memory_order_relaxed);
+  log_rate_limits[key].rate.store(rate, std::memory_order_release);
 }
 
 void sandor_laboratories::robot::log_init(const TaskHandle_t * log_task_handle, log_level_e log_level)
 {
-  active_log_level       = log_level;
-  log_task_h_ptr         = log_task_handle;
-  failed_log_allocations = 0;
-  log_buffer = new circular_buffer_c<log_entry_s>(LOG_BUFFER_ENTRIES, true);
+  clock_init();
+  change_log_level(log_level);
+  for(unsigned int key = 0; key < LOG_KEY_MAX; key++)
+  {
+    log_rate_limits[key].rate.store(0, std::memory_order_relaxed);
+  }
+  log_task_h_ptr               = log_task_handle;
+  log_drops_full               = 0;
+  log_drops_rate_limited       = 0;
+  for(unsigned int level = 0; level <= LOG_LEVEL_ALL; level++)
+  {
+    log_drops_level[level] = 0;
+  }
+  for(unsigned int key = 0; key < LOG_KEY_MAX; key++)
+  {
+    log_drops_key[key] = 0;
+  }
+  memset(&log_drops_reported, 0, sizeof(log_drops_reported));
+  log_time_sync_pending        = true;
+  log_buffer = new circular_buffer_record_c(LOG_BUFFER_SIZE);
+  for(unsigned int i = 0; i < LOG_TASK_BUFFERS_MAX; i++)
+  {
+    log_task_buffers[i] = new circular_buffer_record_c(LOG_TASK_BUFFER_SIZE, true);
+    log_task_buffer_states[i].store(LOG_TASK_BUFFER_FREE, std::memory_order_release);
+  }
+}
+
+void sandor_laboratories::robot::log_task_unregister()
+{
+  ASSERT(task_context());
+
+  const circular_buffer_record_c * const buffer = (circular_buffer_record_c *) task_local_storage_get(SL_ROBOT_LOG_TLS_INDEX);
+  for(unsigned int i = 0; i < LOG_TASK_BUFFERS_MAX; i++)
+  {
+    if(buffer == log_task_buffers[i])
+    {
+      /* Release so log_flush() sees all entries commited before the buffer was released */
+      log_task_buffer_states[i].store(LOG_TASK_BUFFER_RELEASED, std::memory_order_release);
+    }
+  }
+  task_local_storage_set(SL_ROBOT_LOG_TLS_INDEX, nullptr);
+}
+
+void sandor_laboratories::robot::log_set_sink(log_sink_c * sink)
+{
+  ASSERT(sink);
+  log_sink              = sink;
+  log_time_sync_pending = true;
+}
+
+void sandor_laboratories::robot::log_get_drop_counts(log_drop_counts_s * drop_counts)
+{
+  ASSERT(drop_counts);
+
+  drop_counts->full         = log_drops_full.load(std::memory_order_relaxed);
+  drop_counts->rate_limited = log_drops_rate_limited.load(std::memory_order_relaxed);
+  for(unsigned int level = 0; level <= LOG_LEVEL_ALL; level++)
+  {
+    drop_counts->level[level] = log_drops_level[level].load(std::memory_order_relaxed);
+  }
+  for(unsigned int key = 0; key < LOG_KEY_MAX; key++)
+  {
+    drop_counts->key[key] = log_drops_key[key].load(std::memory_order_relaxed);
+  }
+}
+
+/* Formats log entry of payload_length bytes as text, including header.  Returns formatted length excluding null terminator */
+static size_t log_format_entry(const log_entry_s * log_entry, size_t payload_length, char * output_buffer, size_t output_size)
+{
+  const int header_length = snprintf(output_buffer, output_size, LOG_HDR_STRING_FORMAT, 
+    log_entry->hdr.key, log_entry->hdr.level, log_entry->hdr.timestamp);
+  ASSERT((header_length > 0) && (((size_t) header_length) < output_size));
+
+  char * const payload_buffer = &output_buffer[header_length];
+  const size_t payload_size   = (output_size - header_length);
+  int          formatted_length;
+
+  if(LOG_FORMAT_BINARY == log_entry->hdr.format)
+  {
+    /* Arguments beyond those stored are zeroed */
+    log_binary_payload_s payload;
+    memset(&payload, 0, sizeof(payload));
+    memcpy(&payload, log_entry->payload, (payload_length < sizeof(payload)) ? payload_length : sizeof(payload));
+    /* Unused trailing arguments are ignored by snprintf */
+    static_assert(8 == SL_ROBOT_LOG_BINARY_MAX_ARGS, "binary log formatting expects 8 arguments");
+    formatted_length = snprintf(payload_buffer, payload_size, payload.format,
+      payload.args[0], payload.args[1], payload.args[2], payload.args[3], 
+      payload.args[4], payload.args[5], payload.args[6], payload.args[7]);
+  }
+  else
+  {
+    formatted_length = snprintf(payload_buffer, payload_size, "%.*s", (int) payload_length, log_entry->payload);
+  }
+
+  /* Account for truncation */
+  if(formatted_length < 0)
+  {
+    formatted_length = 0;
+  }
+  else if(((size_t) formatted_length) >= payload_size)
+  {
+    formatted_length = (payload_size - 1);
+  }
+
+  return (header_length + formatted_length);
+}
+
+/* Adds entry to the pending sink batch, formatting it if the sink takes text.  Entry must remain valid until the batch is written */
+static void log_batch_add(const log_entry_s * log_entry, size_t payload_length)
+{
+  log_sink_record_s * const record = &log_batch_records[log_batch.count++];
+
+  ASSERT(log_batch.count <= SL_ROBOT_LOG_SINK_BATCH_RECORDS);
+
+  record->entry          = log_entry;
+  record->payload_length = payload_length;
+  record->text           = nullptr;
+  record->text_length    = 0;
+
+  if(LOG_SINK_FORMAT_TEXT == log_sink->format())
+  {
+    ASSERT((LOG_FLUSH_TEXT_SIZE - log_batch.text_length) >= SL_ROBOT_LOG_SINK_LINE_SIZE);
+    char * const line = &log_batch_text[log_batch.text_length];
+    /* Reserve space for line ending, "\r\n" as Serial.println() sends */
+    size_t line_length = log_format_entry(log_entry, payload_length, line, (SL_ROBOT_LOG_SINK_LINE_SIZE-2));
+    line[line_length++] = '\r';
+    line[line_length++] = '\n';
+
+    record->text           = line;
+    record->text_length    = line_length;
+    log_batch.text_length += line_length;
+  }
+}
+/* Returns 'true' if the pending sink batch may not fit another entry */
+static inline bool log_batch_full()
+{
+  return ((SL_ROBOT_LOG_SINK_BATCH_RECORDS == log_batch.count) ||
+          ((LOG_FLUSH_TEXT_SIZE - log_batch.text_length) < SL_ROBOT_LOG_SINK_LINE_SIZE));
+}
+/* Writes pending sink batch, if any */
+static void log_batch_write()
+{
+  if(log_batch.count)
+  {
+    log_sink->write(&log_batch);
+    log_batch.count       = 0;
+    log_batch.text_length = 0;
+  }
+}
+
+/* Writes an internal log entry directly to the sink, if level is enabled for key */
+static void log_report(log_key_e key, log_level_e level, log_timestamp_t timestamp, const char * format, va_list args)
+{
+  if(log_level_enabled(key, level))
+  {
+    log_entry_s log_entry;
+
+    log_entry.hdr.key       = key;
+    log_entry.hdr.level     = level;
+    log_entry.hdr.timestamp = timestamp;
+    log_entry.hdr.format    = LOG_FORMAT_TEXT;
+    vsnprintf(log_entry.payload, sizeof(log_entry.payload), format, args);
+
+    log_batch_add(&log_entry, (strlen(log_entry.payload)+1));
+    log_batch_write();
+  }
+}
+/* Writes a drop report directly to the sink, if level is enabled for LOG_KEY_LOG_DROP */
+static void log_drop_report(log_level_e level, const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  log_report(LOG_KEY_LOG_DROP, level, get_timestamp(), format, args);
+  va_end(args);
+}
+/* Writes a time sync entry holding the full 64-bit time of its timestamp, so text logs can be read across timestamp wraps */
+static void log_time_sync(time_us_t now, const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  log_report(LOG_KEY_LOG_TIME_SYNC, LOG_LEVEL_INFO, (log_timestamp_t) now, format, args);
+  va_end(args);
+}
+
+/* Log buffer being merged by log_flush() */
+typedef struct
+{
+  circular_buffer_record_c *buffer;
+  /* Position after the oldest unmerged entry, and after the last merged entry */
+  circular_buffer_index_t   position;
+  circular_buffer_index_t   merged_position;
+  /* Oldest unmerged entry, nullptr once no more commited entries are available */
+  const log_entry_s *       entry;
+  size_t                    entry_length;
+} log_flush_source_s;
+
+static inline void log_flush_source_next(log_flush_source_s * source)
+{
+  source->entry = (const log_entry_s *) source->buffer->peek_next(&source->position, &source->entry_length);
+}
+/* Writes pending sink batch and frees merged entries */
+static void log_flush_batch(log_flush_source_s * sources, size_t source_count)
+{
+  log_batch_write();
+  for(size_t i = 0; i < source_count; i++)
+  {
+    sources[i].buffer->pop_to(sources[i].merged_position);
+  }
 }
 
 void sandor_laboratories::robot::log_flush()
 {
-  char output_buffer[SL_ROBOT_LOG_PAYLOAD_SIZE+16];
+  /* Collect shared and task log buffers */
+  log_flush_source_s      sources[1+LOG_TASK_BUFFERS_MAX];
+  log_task_buffer_state_e task_buffer_states[LOG_TASK_BUFFERS_MAX];
+  size_t                  source_count = 0;
+  sources[source_count++].buffer = log_buffer;
+  for(unsigned int i = 0; i < LOG_TASK_BUFFERS_MAX; i++)
+  {
+    task_buffer_states[i] = log_task_buffer_states[i].load(std::memory_order_acquire);
+    if(LOG_TASK_BUFFER_FREE != task_buffer_states[i])
+    {
+      sources[source_count++].buffer = log_task_buffers[i];
+    }
+  }
+  for(size_t i = 0; i < source_count; i++)
+  {
+    sources[i].position        = sources[i].buffer->peek_position();
+    sources[i].merged_position = sources[i].position;
+    log_flush_source_next(&sources[i]);
+  }
 
-  /* Log pending log entries */
-  while(log_buffer->available())
+  /* Merge pending log entries by timestamp and pass them to the sink in batches. 
+      Entries are read in place and freed once their batch is written */
+  while(true)
   {
-    const log_entry_s * log_entry = log_buffer->peek_ptr();
-    ASSERT(log_entry);
-    snprintf(output_buffer, sizeof(output_buffer), LOG_HDR_STRING_FORMAT "%s", 
-      log_entry->hdr.key, log_entry->hdr.level, log_entry->hdr.timestamp, log_entry->payload);
-    log_buffer->pop_void();
-    Serial.println(output_buffer);
+    log_flush_source_s * oldest = nullptr;
+    for(size_t i = 0; i < source_count; i++)
+    {
+      if(sources[i].entry && 
+         ((nullptr == oldest) || log_timestamp_before(sources[i].entry->hdr.timestamp, oldest->entry->hdr.timestamp)))
+      {
+        oldest = &sources[i];
+      }
+    }
+    if(nullptr == oldest)
+    {
+      break;
+    }
+
+    log_batch_add(oldest->entry, (oldest->entry_length - offsetof(log_entry_s, payload)));
+    oldest->merged_position = oldest->position;
+    log_flush_source_next(oldest);
+
+    if(log_batch_full())
+    {
+      log_flush_batch(sources, source_count);
+    }
   }
+  log_flush_batch(sources, source_count);
 
-  /* Log warning if log entries were dropped */
-  failed_log_allocations_t failed_allocations = get_and_clear_failed_log_allocations();
-  if(failed_allocations && (LOG_LEVEL_WARNING <= active_log_level))
+  /* Free released task log buffers once emptied */
+  for(unsigned int i = 0; i < LOG_TASK_BUFFERS_MAX; i++)
   {
-    snprintf(output_buffer, sizeof(output_buffer), LOG_HDR_STRING_FORMAT "WARNING - %u log entries dropped!", 
-      LOG_KEY_LOG_DROP, LOG_LEVEL_WARNING, get_timestamp(), failed_allocations);
-    Serial.println(output_buffer);
+    if((LOG_TASK_BUFFER_RELEASED == task_buffer_states[i]) && (0 == log_task_buffers[i]->used()))
+    {
+      log_task_buffer_states[i].store(LOG_TASK_BUFFER_FREE, std::memory_order_release);
+    }
   }
 
-  Serial.flush();
+  /* Report log entries dropped since last flush */
+  log_drop_counts_s drop_counts;
+  log_get_drop_counts(&drop_counts);
+  if(drop_counts.full != log_drops_reported.full)
+  {
+    log_drop_report(LOG_LEVEL_WARNING, "WARNING - %u log entries dropped!", (drop_counts.full - log_drops_reported.full));
+  }
+  if(drop_counts.rate_limited != log_drops_reported.rate_limited)
+  {
+    log_drop_report(LOG_LEVEL_WARNING, "WARNING - %u log entries rate limited!", (drop_counts.rate_limited - log_drops_reported.rate_limited));
+  }
+  for(unsigned int key = 0; key < LOG_KEY_MAX; key++)
+  {
+    if(drop_counts.key[key] != log_drops_reported.key[key])
+    {
+      log_drop_report(LOG_LEVEL_WARNING, "WARNING - %u log entries dropped for key 0x%02x!", (drop_counts.key[key] - log_drops_reported.key[key]), key);
+    }
+  }
+  /* Faults were lost despite the reserve */
+  const log_drop_count_t error_drops   = (drop_counts.level[LOG_LEVEL_ERROR]   - log_drops_reported.level[LOG_LEVEL_ERROR]);
+  const log_drop_count_t warning_drops = (drop_counts.level[LOG_LEVEL_WARNING] - log_drops_reported.level[LOG_LEVEL_WARNING]);
+  if(error_drops || warning_drops)
+  {
+    log_drop_report(LOG_LEVEL_ERROR, "ERROR - %u error and %u warning log entries dropped!", error_drops, warning_drops);
+  }
+  log_drops_reported = drop_counts;
+
+  /* Text timestamps wrap, binary log files sync 64-bit time in each block header */
+  const time_us_t now = clock_us();
+  if((LOG_SINK_FORMAT_TEXT == log_sink->format()) &&
+     (log_time_sync_pending || ((now - log_time_sync_last) >= ((time_us_t) SL_ROBOT_LOG_TIME_SYNC_PERIOD_MS * 1000))))
+  {
+    log_time_sync(now, "TIME SYNC - 0x%08lx%08lx us", (unsigned long) (now >> 32), (unsigned long) now);
+    log_time_sync_last    = now;
+    log_time_sync_pending = false;
+  }
+
+  log_sink->flush();
 }
 
-log_entry_s * sandor_laboratories::robot::log_entry_allocate(log_key_e key, log_level_e level)
+bool sandor_laboratories::robot::log_level_enabled(log_key_e key, log_level_e level)
+{
+  return ((key < LOG_KEY_MAX) &&
+          (level <= log_compile_level(key)) && 
+          (level <= active_log_levels[key].load(std::memory_order_relaxed)));
+}
+
+log_entry_s * sandor_laboratories::robot::log_entry_allocate(log_key_e key, log_level_e level, size_t payload_length)
 {
   log_entry_s * ret_value = nullptr;
 
-  if(level <= active_log_level)
+  ASSERT(payload_length <= SL_ROBOT_LOG_PAYLOAD_SIZE);
+
+  if(!log_level_enabled(key, level))
   {
-    ret_value = log_buffer->allocate();
+    /* Level filtered */
+  }
+  else if(!log_rate_limit_take(key))
+  {
+    log_drop(log_drops_rate_limited, key, level);
+  }
+  else
+  {
+    /* Only ERROR and WARNING entries may use the reserve */
+    const circular_buffer_index_t reserve = (level > LOG_LEVEL_WARNING) ? LOG_RESERVE_SIZE : 0;
+    ret_value = (log_entry_s *) log_producer_buffer()->allocate((offsetof(log_entry_s, payload) + payload_length), reserve);
     if(ret_value)
     {
       ret_value->hdr.level     = level;
       ret_value->hdr.key       = key;
       ret_value->hdr.timestamp = get_timestamp();
+      ret_value->hdr.format    = LOG_FORMAT_TEXT;
     }
     else
     {
-      critical_section_enter();
-      failed_log_allocations++;
-      critical_section_exit();
+      log_drop(log_drops_full, key, level);
     }
   }
 
@@ -108,27 +559,37 @@ log_entry_s * sandor_laboratories::robot::log_entry_allocate(log_key_e key, log_
 }
 
 void sandor_laboratories::robot::log_entry_commit(const log_entry_s * log_entry)
+{
+  log_entry_commit(log_entry, SL_ROBOT_LOG_PAYLOAD_SIZE);
+}
+void sandor_laboratories::robot::log_entry_commit(const log_entry_s * log_entry, size_t payload_length)
 {
   if(log_entry)
   {
-    log_buffer->commit(log_entry);
+    circular_buffer_record_c * buffer = log_producer_buffer();
+    if(!buffer->contains(log_entry))
+    {
+      buffer = log_buffer;
+    }
+    buffer->commit(log_entry, (offsetof(log_entry_s, payload) + payload_length));
     if(*log_task_h_ptr)
     {
-      xTaskNotifyGive(*log_task_h_ptr);
+      task_notify(*log_task_h_ptr);
     }
   }
 }
 
 void sandor_laboratories::robot::log_cstring(log_key_e key, log_level_e level, const char *log_string)
 {
-  log_entry_s * log_entry = log_entry_allocate(key, level);
-
   ASSERT(log_string);
 
+  const size_t  string_length = strnlen(log_string, (SL_ROBOT_LOG_PAYLOAD_SIZE-1));
+  log_entry_s * log_entry     = log_entry_allocate(key, level, (string_length+1));
+
   if(log_entry)
   {
-    strncpy(log_entry->payload, log_string, sizeof(log_entry->payload));
-    log_entry->payload[sizeof(log_entry->payload)-1] = '\0';
+    memcpy(log_entry->payload, log_string, string_length);
+    log_entry->payload[string_length] = '\0';
     log_entry_commit(log_entry);
   }
 }
\ No newline at end of file
@@ -9,17 +9,29 @@
 #define __SL_ROBOT_LOG_HPP__
 
 #include <cstdarg>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <type_traits>
 
 namespace sandor_laboratories
 {
   namespace robot
   {
-    /* Log size minus 5 bytes for packing (1 byte circular buffer header + 4 bytes log header*/
-    #define SL_ROBOT_LOG_PAYLOAD_SIZE (128-5)
+    /* Log size minus 6 bytes for packing (6 bytes log header) */
+    #define SL_ROBOT_LOG_PAYLOAD_SIZE (128-6)
+    /* Maximum arguments stored by a binary log entry */
+    #define SL_ROBOT_LOG_BINARY_MAX_ARGS 8
 
+    /* Log timestamp in microseconds, the low 32 bits of clock_us().  Wraps every ~71 minutes, so text sinks are sent a
+        LOG_KEY_LOG_TIME_SYNC entry holding the full 64-bit time at least every SL_ROBOT_LOG_TIME_SYNC_PERIOD_MS, and
+        the binary log file carries 64-bit time in each block header */
     typedef uint32_t log_timestamp_t;
+    /* Longest time between time sync entries in text logs, must be well below the timestamp wrap */
+    #ifndef SL_ROBOT_LOG_TIME_SYNC_PERIOD_MS
+    #define SL_ROBOT_LOG_TIME_SYNC_PERIOD_MS 60000
+    #endif
 
     typedef enum
     {
@@ -35,6 +47,7 @@ namespace sandor_laboratories
       LOG_KEY_MOTOR_CONTROL_LOOP_RIGHT,
       /* Internal Log Keys */
       LOG_KEY_LOG_DROP,
+      LOG_KEY_LOG_TIME_SYNC,
       LOG_KEY_MAX,
     } log_key_e;
 
@@ -52,15 +65,98 @@ namespace sandor_laboratories
       LOG_LEVEL_ALL = LOG_LEVEL_DEBUG_3,
     } log_level_e;
 
+    /* Compile-time log levels.  Log calls through the LOG_* macros above these levels are removed entirely, 
+        including evaluation of their arguments.  Runtime levels set with change_log_level() apply beneath them.
+        SL_ROBOT_LOG_COMPILE_LEVEL sets the build-wide level and SL_ROBOT_LOG_COMPILE_LEVEL_<KEY> overrides a single key
+        (per key levels are only eliminated at compile time when the log key is a constant) */
+    #ifndef SL_ROBOT_LOG_COMPILE_LEVEL
+    #define SL_ROBOT_LOG_COMPILE_LEVEL LOG_LEVEL_ALL
+    #endif
+    #ifndef SL_ROBOT_LOG_COMPILE_LEVEL_UNKNOWN
+    #define SL_ROBOT_LOG_COMPILE_LEVEL_UNKNOWN SL_ROBOT_LOG_COMPILE_LEVEL
+    #endif
+    #ifndef SL_ROBOT_LOG_COMPILE_LEVEL_BOOT
+    #define SL_ROBOT_LOG_COMPILE_LEVEL_BOOT SL_ROBOT_LOG_COMPILE_LEVEL
+    #endif
+    #ifndef SL_ROBOT_LOG_COMPILE_LEVEL_DEBUG_TASK
+    #define SL_ROBOT_LOG_COMPILE_LEVEL_DEBUG_TASK SL_ROBOT_LOG_COMPILE_LEVEL
+    #endif
+    #ifndef SL_ROBOT_LOG_COMPILE_LEVEL_FAILSAFE
+    #define SL_ROBOT_LOG_COMPILE_LEVEL_FAILSAFE SL_ROBOT_LOG_COMPILE_LEVEL
+    #endif
+    #ifndef SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_DRIVER
+    #define SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_DRIVER SL_ROBOT_LOG_COMPILE_LEVEL
+    #endif
+    #ifndef SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_DRIVER_LEFT
+    #define SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_DRIVER_LEFT SL_ROBOT_LOG_COMPILE_LEVEL
+    #endif
+    #ifndef SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_DRIVER_RIGHT
+    #define SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_DRIVER_RIGHT SL_ROBOT_LOG_COMPILE_LEVEL
+    #endif
+    #ifndef SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_CONTROL_LOOP
+    #define SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_CONTROL_LOOP SL_ROBOT_LOG_COMPILE_LEVEL
+    #endif
+    #ifndef SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_CONTROL_LOOP_LEFT
+    #define SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_CONTROL_LOOP_LEFT SL_ROBOT_LOG_COMPILE_LEVEL
+    #endif
+    #ifndef SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_CONTROL_LOOP_RIGHT
+    #define SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_CONTROL_LOOP_RIGHT SL_ROBOT_LOG_COMPILE_LEVEL
+    #endif
+    #ifndef SL_ROBOT_LOG_COMPILE_LEVEL_LOG_DROP
+    #define SL_ROBOT_LOG_COMPILE_LEVEL_LOG_DROP SL_ROBOT_LOG_COMPILE_LEVEL
+    #endif
+    #ifndef SL_ROBOT_LOG_COMPILE_LEVEL_LOG_TIME_SYNC
+    #define SL_ROBOT_LOG_COMPILE_LEVEL_LOG_TIME_SYNC SL_ROBOT_LOG_COMPILE_LEVEL
+    #endif
+
+    constexpr log_level_e log_compile_levels[LOG_KEY_MAX] =
+      {
+        SL_ROBOT_LOG_COMPILE_LEVEL_UNKNOWN,
+        SL_ROBOT_LOG_COMPILE_LEVEL_BOOT,
+        SL_ROBOT_LOG_COMPILE_LEVEL_DEBUG_TASK,
+        SL_ROBOT_LOG_COMPILE_LEVEL_FAILSAFE,
+        SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_DRIVER,
+        SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_DRIVER_LEFT,
+        SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_DRIVER_RIGHT,
+        SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_CONTROL_LOOP,
+        SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_CONTROL_LOOP_LEFT,
+        SL_ROBOT_LOG_COMPILE_LEVEL_MOTOR_CONTROL_LOOP_RIGHT,
+        SL_ROBOT_LOG_COMPILE_LEVEL_LOG_DROP,
+        SL_ROBOT_LOG_COMPILE_LEVEL_LOG_TIME_SYNC,
+      };
+
+    /* Compile-time log level of a given key */
+    constexpr log_level_e log_compile_level(log_key_e key)
+    {
+      return (key < LOG_KEY_MAX) ? log_compile_levels[key] : SL_ROBOT_LOG_COMPILE_LEVEL;
+    }
+    /* Highest compile-time log level of any key, allows elimination when the key is not constant */
+    constexpr log_level_e log_compile_level_max(unsigned int key_index=0, log_level_e max_level=LOG_LEVEL_NONE)
+    {
+      return (key_index >= LOG_KEY_MAX) ? max_level :
+             log_compile_level_max(key_index+1, (log_compile_levels[key_index] > max_level) ? log_compile_levels[key_index] : max_level);
+    }
+
+    typedef enum
+    {
+      /* Payload is a formatted, null terminated string */
+      LOG_FORMAT_TEXT,
+      /* Payload is a log_binary_payload_s, formatted when flushed */
+      LOG_FORMAT_BINARY,
+    } log_format_e;
+
     typedef struct __attribute__((packed))
     {
       log_level_e     level:3;
       log_key_e       key:5;
-      log_timestamp_t timestamp:24;
+      log_format_e    format:8;
+      log_timestamp_t timestamp;
     }
     log_entry_header_s;
 
-    typedef struct __attribute__((packed))
+    /* Word aligned so buffer copies use aligned accesses.
+        Entries are stored as variable-length records, so only the allocated payload length is backed by memory */
+    typedef struct __attribute__((packed, aligned(4)))
     {
       log_entry_header_s hdr;
 
@@ -68,27 +164,123 @@ namespace sandor_laboratories
 
     } log_entry_s;
 
-    log_entry_s * log_entry_allocate(log_key_e, log_level_e);
+    /* Returns 'true' if level is active at runtime for key */
+    bool          log_level_enabled(log_key_e, log_level_e);
+    /* Log entry allocation and commit never block and may be called from tasks or interrupts.
+        Only the first payload_length bytes of the returned entry's payload may be written */
+    log_entry_s * log_entry_allocate(log_key_e, log_level_e, size_t payload_length = SL_ROBOT_LOG_PAYLOAD_SIZE);
     void          log_entry_commit(const log_entry_s *);
+    /* Commits entry allocated at a larger payload length, keeping only the first payload_length bytes of its payload */
+    void          log_entry_commit(const log_entry_s *, size_t payload_length);
     void          log_cstring(log_key_e, log_level_e, const char *);
+    /* Releases the calling task's log buffer for reuse by other tasks, call before deleting a task that has logged.
+        All of the task's entries must be commited, they are still written by log_flush() */
+    void          log_task_unregister();
+    /* Change runtime log level of all keys */
     void          change_log_level(log_level_e);
+    /* Change runtime log level of a single key */
+    void          change_log_level(log_key_e, log_level_e);
 
-    inline void log_snprintf(log_key_e key, log_level_e level, const char *string, ...)
+    /* Log rate limit type, in entries per second */
+    typedef uint32_t log_rate_t;
+    /* Limit key to rate entries per second with bursts of up to burst entries (token bucket).  A rate of 0 disables limiting */
+    void          log_rate_limit(log_key_e, log_rate_t rate, log_rate_t burst);
+
+    /* Dropped log entry counts since log_init() */
+    typedef uint32_t log_drop_count_t;
+    typedef struct
+    {
+      /* Dropped as the log buffer was full */
+      log_drop_count_t full;
+      /* Dropped by rate limiting */
+      log_drop_count_t rate_limited;
+      /* All drops by level and by key */
+      log_drop_count_t level[LOG_LEVEL_ALL+1];
+      log_drop_count_t key[LOG_KEY_MAX];
+    } log_drop_counts_s;
+    void          log_get_drop_counts(log_drop_counts_s *);
+
+    /* Binary log argument, wide enough for any 32-bit integer type */
+    typedef uint32_t log_binary_arg_t;
+
+    /* Binary log payload.  Only the format string pointer and raw arguments are stored, 
+        so the format string must have static storage duration (e.g. a string literal) */
+    typedef struct
+    {
+      const char       *format;
+      uint8_t           arg_count;
+      log_binary_arg_t  args[SL_ROBOT_LOG_BINARY_MAX_ARGS];
+    } log_binary_payload_s;
+    static_assert(sizeof(log_binary_payload_s) <= SL_ROBOT_LOG_PAYLOAD_SIZE, "binary log payload exceeds log entry");
+
+    template <typename ARG_T>
+    constexpr log_binary_arg_t log_binary_arg(ARG_T arg)
+    {
+      static_assert((std::is_integral<ARG_T>::value || std::is_enum<ARG_T>::value) && (sizeof(ARG_T) <= sizeof(log_binary_arg_t)),
+                    "binary log arguments must be integers of 32 bits or less");
+      return (log_binary_arg_t) arg;
+    }
+
+    /* Logs format string pointer and integer arguments without formatting.
+        Formatting is deferred to log_flush() so this is cheap enough for hot paths.
+        Only integer conversions (%d, %u, %x, %c and their flags/widths) are supported */
+    template <typename... ARGS_T>
+    inline void log_binary(log_key_e key, log_level_e level, const char *format, ARGS_T... args)
     {
-      va_list args;
-      va_start(args, string);
- 
-      log_entry_s * log_entry = log_entry_allocate(key, level);
+      static_assert(sizeof...(ARGS_T) <= SL_ROBOT_LOG_BINARY_MAX_ARGS, "too many binary log arguments");
+
+      /* Only store the arguments actually passed */
+      constexpr size_t payload_length = offsetof(log_binary_payload_s, args) + (sizeof...(ARGS_T) * sizeof(log_binary_arg_t));
+
+      log_entry_s * log_entry = log_entry_allocate(key, level, payload_length);
       if(log_entry)
       {
-        vsnprintf(log_entry->payload, sizeof(log_entry->payload), string, args);
+        const log_binary_payload_s payload = {format, sizeof...(ARGS_T), {log_binary_arg(args)...}};
+        memcpy(log_entry->payload, &payload, payload_length);
+        log_entry->hdr.format = LOG_FORMAT_BINARY;
         log_entry_commit(log_entry);
       }
+    }
+
+    inline void log_snprintf(log_key_e key, log_level_e level, const char *string, ...)
+    {
+      /* Allocate the maximum payload and format straight into it, so rate limited or dropped entries are never formatted.
+          The entry is shrunk to the bytes the message used when commited */
+      log_entry_s * log_entry = log_entry_allocate(key, level, SL_ROBOT_LOG_PAYLOAD_SIZE);
+      if(log_entry)
+      {
+        va_list args;
+        va_start(args, string);
+        const int string_length = vsnprintf(log_entry->payload, SL_ROBOT_LOG_PAYLOAD_SIZE, string, args);
+        va_end(args);
 
-      va_end(args);
+        if(string_length < 0)
+        {
+          log_entry->payload[0] = '\0';
+        }
+        const size_t payload_length = (string_length < 0) ? 1 :
+                                      ((size_t) string_length < SL_ROBOT_LOG_PAYLOAD_SIZE) ? (string_length + 1) : SL_ROBOT_LOG_PAYLOAD_SIZE;
+        log_entry_commit(log_entry, payload_length);
+      }
     }
 
   }
 }
 
+/* Logging macros - calls above the compile-time level and their arguments compile away, 
+    and arguments are only evaluated if the level is active at runtime */
+#define LOG_IF_ENABLED(key, level, log_call) \
+  do \
+  { \
+    if(((level) <= ::sandor_laboratories::robot::log_compile_level_max()) && \
+       ((level) <= ::sandor_laboratories::robot::log_compile_level(key)) && \
+       ::sandor_laboratories::robot::log_level_enabled((key), (level))) \
+    { \
+      log_call; \
+    } \
+  } while(0)
+#define LOG_SNPRINTF(key, level, ...) LOG_IF_ENABLED(key, level, ::sandor_laboratories::robot::log_snprintf((key), (level), __VA_ARGS__))
+#define LOG_CSTRING(key, level, string) LOG_IF_ENABLED(key, level, ::sandor_laboratories::robot::log_cstring((key), (level), (string)))
+#define LOG_BINARY(key, level, ...) LOG_IF_ENABLED(key, level, ::sandor_laboratories::robot::log_binary((key), (level), __VA_ARGS__))
+
 #endif /* __SL_ROBOT_LOG_HPP__ */
\ No newline at end of file
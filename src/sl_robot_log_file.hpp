@@ -0,0 +1,90 @@
+/*
+  sl_robot_log_file.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_ROBOT_LOG_FILE_HPP__
+#define __SL_ROBOT_LOG_FILE_HPP__
+
+#include <cstdint>
+
+/* Binary log file format, shared by log_sink_binary_file_c and the host decoder (tools/sl_robot_log_decode.cpp).
+    All fields are little endian.
+    The file is a sequence of fixed size blocks.  The first block holds only the file header,
+      so every following block stays aligned to storage sectors.
+    Each block starts with a block header holding a 64-bit time sync (absolute time of the block in microseconds),
+      the time span and the set of log keys it contains, so a reader can binary search by time and skip blocks
+      by key while reading only block headers.
+    Blocks are self contained: entry times are offsets from the block time and binary format strings are
+      repeated in each block where they are used.
+    Records follow the block header back to back, a record type of LOG_FILE_RECORD_END ends the block early. */
+
+namespace sandor_laboratories
+{
+  namespace robot
+  {
+    #define SL_ROBOT_LOG_FILE_MAGIC       0x4C52534C /* "SLRL" */
+    #define SL_ROBOT_LOG_FILE_BLOCK_MAGIC 0x4252534C /* "SLRB" */
+    #define SL_ROBOT_LOG_FILE_VERSION     2
+    #define SL_ROBOT_LOG_FILE_BLOCK_SIZE  512
+
+    typedef uint64_t log_file_time_t;
+
+    /* File header, padded to a full block */
+    typedef struct __attribute__((packed))
+    {
+      uint32_t magic;
+      uint16_t version;
+      uint16_t block_size;
+    } log_file_header_s;
+
+    typedef struct __attribute__((packed))
+    {
+      uint32_t        magic;
+      /* Block number, starting at 0 for the first block after the file header */
+      uint32_t        sequence;
+      /* Time sync - absolute time of the block in microseconds, record times are relative to it */
+      log_file_time_t time;
+      /* Latest record time offset in the block, in microseconds */
+      uint32_t        duration;
+      /* Bit (1 << key) is set for each log_key_e with an entry in the block */
+      uint32_t        key_mask;
+      uint16_t        record_count;
+      /* Bytes used in the block, including this header */
+      uint16_t        used_length;
+      uint32_t        reserved;
+    } log_file_block_header_s;
+    static_assert(sizeof(log_file_block_header_s) == 32, "log file block header must be 32 bytes");
+
+    typedef enum
+    {
+      /* Remainder of block is unused */
+      LOG_FILE_RECORD_END,
+      /* Text entry, body is the message without null terminator */
+      LOG_FILE_RECORD_TEXT,
+      /* Binary entry, body is a 32-bit format string id followed by 32-bit arguments */
+      LOG_FILE_RECORD_BINARY,
+      /* Binary format string definition, time_offset holds the format string id and body is the string */
+      LOG_FILE_RECORD_FORMAT,
+    } log_file_record_type_e;
+
+    typedef struct __attribute__((packed))
+    {
+      uint8_t type;
+      /* Record length in bytes, including this header */
+      uint8_t length;
+      uint8_t key;
+      uint8_t level;
+      /* Signed offset of entry time from block time in microseconds */
+      int32_t time_offset;
+    } log_file_record_header_s;
+    static_assert(sizeof(log_file_record_header_s) == 8, "log file record header must be 8 bytes");
+
+    /* Largest record body */
+    #define SL_ROBOT_LOG_FILE_RECORD_BODY_MAX (UINT8_MAX - sizeof(log_file_record_header_s))
+  }
+}
+
+#endif /* __SL_ROBOT_LOG_FILE_HPP__ */
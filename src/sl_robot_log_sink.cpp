@@ -0,0 +1,306 @@
+/*
+  sl_robot_log_sink.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <Arduino.h>
+#include <cstring>
+
+#if defined(__unix__)
+#include <cerrno>
+#include <sys/uio.h>
+#endif
+
+#include "sl_robot_clock.hpp"
+#include "sl_robot_log_sink.hpp"
+#include "sl_robot_utils.hpp"
+
+using namespace sandor_laboratories::robot;
+
+void log_sink_serial_c::write(const log_sink_batch_s *batch)
+{
+  ASSERT(batch);
+  /* Lines are contiguous, so the whole batch is one write */
+  output.write((const uint8_t *) batch->text, batch->text_length);
+}
+void log_sink_serial_c::flush()
+{
+  output.flush();
+}
+
+#if defined(__unix__)
+void log_sink_file_c::write(const log_sink_batch_s *batch)
+{
+  struct iovec iov[2*SL_ROBOT_LOG_SINK_BATCH_RECORDS];
+  uint8_t      record_lengths[SL_ROBOT_LOG_SINK_BATCH_RECORDS][2];
+  int          iov_count = 0;
+
+  ASSERT(batch);
+  ASSERT(batch->count <= SL_ROBOT_LOG_SINK_BATCH_RECORDS);
+
+  if(LOG_SINK_FORMAT_BINARY == file_format)
+  {
+    for(size_t i = 0; i < batch->count; i++)
+    {
+      const size_t record_length = offsetof(log_entry_s, payload) + batch->records[i].payload_length;
+      record_lengths[i][0] = (uint8_t) (record_length & 0xFF);
+      record_lengths[i][1] = (uint8_t) (record_length >> 8);
+      iov[iov_count].iov_base   = record_lengths[i];
+      iov[iov_count++].iov_len  = sizeof(record_lengths[i]);
+      iov[iov_count].iov_base   = (void *) batch->records[i].entry;
+      iov[iov_count++].iov_len  = record_length;
+    }
+  }
+  else if(batch->text_length)
+  {
+    iov[iov_count].iov_base   = (void *) batch->text;
+    iov[iov_count++].iov_len  = batch->text_length;
+  }
+
+  /* Continue after partial writes until the batch is written or an error occurs */
+  struct iovec *pending = iov;
+  while(iov_count > 0)
+  {
+    ssize_t written = writev(file_descriptor, pending, iov_count);
+    if(written < 0)
+    {
+      if(EINTR == errno)
+      {
+        continue;
+      }
+      break;
+    }
+    while((iov_count > 0) && ((size_t) written >= pending->iov_len))
+    {
+      written -= pending->iov_len;
+      pending++;
+      iov_count--;
+    }
+    if(iov_count > 0)
+    {
+      pending->iov_base  = ((uint8_t *) pending->iov_base) + written;
+      pending->iov_len  -= written;
+    }
+  }
+}
+#endif
+
+log_sink_memory_c::log_sink_memory_c(size_t constructor_capacity)
+  : capacity(constructor_capacity)
+{
+  capture_buffer = (char *) heap_malloc(capacity+1);
+  clear();
+}
+log_sink_memory_c::~log_sink_memory_c()
+{
+  heap_free((void *) capture_buffer);
+}
+void log_sink_memory_c::write(const log_sink_batch_s *batch)
+{
+  ASSERT(batch);
+
+  const size_t free_length = (capacity - captured_length);
+  const size_t copy_length = (batch->text_length < free_length) ? batch->text_length : free_length;
+
+  memcpy(&capture_buffer[captured_length], batch->text, copy_length);
+  captured_length                 += copy_length;
+  capture_buffer[captured_length]  = '\0';
+  captured_records                += batch->count;
+  dropped_length                  += (batch->text_length - copy_length);
+}
+void log_sink_memory_c::clear()
+{
+  captured_length   = 0;
+  captured_records  = 0;
+  dropped_length    = 0;
+  capture_buffer[0] = '\0';
+}
+
+log_sink_binary_file_c::log_sink_binary_file_c(Print &file_output)
+  : output(file_output), header_written(false), time(0), block_sequence(0)
+{
+  block_reset();
+}
+
+/* Returns 'true' if the format string is already defined in the current block */
+bool log_sink_binary_file_c::block_has_format(const char *format) const
+{
+  bool ret_val = false;
+
+  for(size_t i = 0; (i < block_format_count) && !ret_val; i++)
+  {
+    ret_val = (format == block_formats[i]);
+  }
+
+  return ret_val;
+}
+/* Returns 'true' if a record of length may be appended at time */
+bool log_sink_binary_file_c::block_fits(size_t length, log_file_time_t record_time)
+{
+  const log_file_block_header_s * const header = block_header();
+  bool ret_val = true;
+
+  if(header->record_count)
+  {
+    const int64_t time_offset = (int64_t) (record_time - header->time);
+    ret_val = (((header->used_length + length) <= SL_ROBOT_LOG_FILE_BLOCK_SIZE) &&
+               (time_offset >= INT32_MIN) && (time_offset <= INT32_MAX));
+  }
+
+  return ret_val;
+}
+void log_sink_binary_file_c::block_append(log_file_record_type_e type, uint8_t key, uint8_t level, int32_t time_offset, 
+                                          const void *body, size_t body_length, const void *body_tail, size_t body_tail_length)
+{
+  log_file_block_header_s * const header = block_header();
+  const size_t record_length = sizeof(log_file_record_header_s) + body_length + body_tail_length;
+
+  ASSERT((header->used_length + record_length) <= SL_ROBOT_LOG_FILE_BLOCK_SIZE);
+  ASSERT(record_length <= UINT8_MAX);
+
+  const log_file_record_header_s record_header = {(uint8_t) type, (uint8_t) record_length, key, level, time_offset};
+  uint8_t * record = &block[header->used_length];
+  memcpy(record, &record_header, sizeof(record_header));
+  record += sizeof(record_header);
+  memcpy(record, body, body_length);
+  record += body_length;
+  if(body_tail_length)
+  {
+    memcpy(record, body_tail, body_tail_length);
+  }
+
+  header->used_length += record_length;
+  header->record_count++;
+}
+void log_sink_binary_file_c::block_reset()
+{
+  log_file_block_header_s * const header = block_header();
+
+  memset(block, 0, sizeof(block));
+  header->magic       = SL_ROBOT_LOG_FILE_BLOCK_MAGIC;
+  header->sequence    = block_sequence;
+  header->used_length = sizeof(log_file_block_header_s);
+  block_format_count  = 0;
+  block_has_error     = false;
+}
+void log_sink_binary_file_c::block_write()
+{
+  if(block_header()->record_count)
+  {
+    if(!header_written)
+    {
+      /* File header is padded to a full block */
+      uint8_t header_block[SL_ROBOT_LOG_FILE_BLOCK_SIZE];
+      const log_file_header_s file_header = {SL_ROBOT_LOG_FILE_MAGIC, SL_ROBOT_LOG_FILE_VERSION, SL_ROBOT_LOG_FILE_BLOCK_SIZE};
+      memset(header_block, 0, sizeof(header_block));
+      memcpy(header_block, &file_header, sizeof(file_header));
+      output.write(header_block, sizeof(header_block));
+      header_written = true;
+    }
+
+    output.write(block, sizeof(block));
+    block_sequence++;
+    block_reset();
+  }
+}
+
+void log_sink_binary_file_c::write_entry(const log_sink_record_s *record)
+{
+  const log_entry_s * const entry = record->entry;
+
+  /* Extend 32-bit timestamp by its age relative to the 64-bit clock, valid for entries less than ~71 minutes old */
+  const time_us_t now = clock_us();
+  time = now - (log_timestamp_t) (((log_timestamp_t) now) - entry->hdr.timestamp);
+
+  if(LOG_FORMAT_BINARY == entry->hdr.format)
+  {
+    log_binary_payload_s payload;
+    memset(&payload, 0, sizeof(payload));
+    memcpy(&payload, entry->payload, (record->payload_length < sizeof(payload)) ? record->payload_length : sizeof(payload));
+
+    const size_t   arg_count            = (payload.arg_count < SL_ROBOT_LOG_BINARY_MAX_ARGS) ? payload.arg_count : SL_ROBOT_LOG_BINARY_MAX_ARGS;
+    const uint32_t format_id            = (uint32_t) (uintptr_t) payload.format;
+    const size_t   format_length        = payload.format ? strnlen(payload.format, SL_ROBOT_LOG_FILE_RECORD_BODY_MAX) : 0;
+    const size_t   format_record_length = sizeof(log_file_record_header_s) + format_length;
+    const size_t   entry_record_length  = sizeof(log_file_record_header_s) + sizeof(format_id) + (arg_count * sizeof(log_binary_arg_t));
+
+    /* Format string definition and entry are kept in the same block */
+    if(!block_fits(entry_record_length + (block_has_format(payload.format) ? 0 : format_record_length), time))
+    {
+      block_write();
+    }
+    if(0 == block_header()->record_count)
+    {
+      block_header()->time = time;
+    }
+    if(!block_has_format(payload.format))
+    {
+      block_append(LOG_FILE_RECORD_FORMAT, 0, 0, (int32_t) format_id, payload.format, format_length);
+      if(block_format_count < BLOCK_FORMATS)
+      {
+        block_formats[block_format_count++] = payload.format;
+      }
+    }
+    block_append(LOG_FILE_RECORD_BINARY, entry->hdr.key, entry->hdr.level, (int32_t) (time - block_header()->time),
+                 &format_id, sizeof(format_id), payload.args, (arg_count * sizeof(log_binary_arg_t)));
+  }
+  else
+  {
+    const size_t text_length = strnlen(entry->payload, record->payload_length);
+
+    if(!block_fits(sizeof(log_file_record_header_s) + text_length, time))
+    {
+      block_write();
+    }
+    if(0 == block_header()->record_count)
+    {
+      block_header()->time = time;
+    }
+    block_append(LOG_FILE_RECORD_TEXT, entry->hdr.key, entry->hdr.level, (int32_t) (time - block_header()->time),
+                 entry->payload, text_length);
+  }
+
+  /* Block index */
+  log_file_block_header_s * const header = block_header();
+  const int32_t time_offset = (int32_t) (time - header->time);
+  if((time_offset > 0) && ((uint32_t) time_offset > header->duration))
+  {
+    header->duration = time_offset;
+  }
+  header->key_mask |= (1UL << entry->hdr.key);
+  if(LOG_LEVEL_ERROR == entry->hdr.level)
+  {
+    block_has_error = true;
+  }
+}
+void log_sink_binary_file_c::write(const log_sink_batch_s *batch)
+{
+  ASSERT(batch);
+
+  for(size_t i = 0; i < batch->count; i++)
+  {
+    write_entry(&batch->records[i]);
+  }
+}
+void log_sink_binary_file_c::flush()
+{
+  const log_file_block_header_s * const header = block_header();
+
+  if(header->record_count &&
+     (block_has_error || ((clock_us() - header->time) >= ((time_us_t) SL_ROBOT_LOG_SINK_BINARY_SYNC_PERIOD_MS * 1000))))
+  {
+    sync();
+  }
+  else
+  {
+    output.flush();
+  }
+}
+/* Writes the current partial block, padded to full size, and flushes the stream */
+void log_sink_binary_file_c::sync()
+{
+  block_write();
+  output.flush();
+}
@@ -0,0 +1,197 @@
+/*
+  sl_robot_log_sink.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_ROBOT_LOG_SINK_HPP__
+#define __SL_ROBOT_LOG_SINK_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sl_robot_log.hpp"
+#include "sl_robot_log_file.hpp"
+
+class Print;
+
+namespace sandor_laboratories
+{
+  namespace robot
+  {
+    /* Maximum records passed to a sink in one batch */
+    #define SL_ROBOT_LOG_SINK_BATCH_RECORDS 16
+    /* Maximum length of a formatted log line, including header and line ending */
+    #define SL_ROBOT_LOG_SINK_LINE_SIZE (SL_ROBOT_LOG_PAYLOAD_SIZE+24)
+
+    typedef enum
+    {
+      /* Sink receives records formatted as lines of text */
+      LOG_SINK_FORMAT_TEXT,
+      /* Sink receives raw log entries, text is not formatted */
+      LOG_SINK_FORMAT_BINARY,
+    } log_sink_format_e;
+
+    /* Single log record within a batch */
+    typedef struct
+    {
+      /* Raw log entry, only payload_length bytes of its payload are valid */
+      const log_entry_s *entry;
+      size_t             payload_length;
+      /* Formatted line ending in "\r\n" (not null terminated), only set for text sinks */
+      const char        *text;
+      size_t             text_length;
+    } log_sink_record_s;
+
+    /* Batch of log records passed to a sink */
+    typedef struct
+    {
+      const log_sink_record_s *records;
+      size_t                   count;
+      /* All formatted lines in order, contiguous so text sinks may write the batch at once.  Only set for text sinks */
+      const char              *text;
+      size_t                   text_length;
+    } log_sink_batch_s;
+
+    /* Log sink interface, batches are written from the log task by log_flush() */
+    class log_sink_c
+    {
+      public:
+        virtual ~log_sink_c() {}
+
+        /* Format of records this sink receives */
+        virtual log_sink_format_e format() const {return LOG_SINK_FORMAT_TEXT;}
+        /* Writes a batch of records.  Record data is only valid during the call */
+        virtual void              write(const log_sink_batch_s *batch) = 0;
+        /* Flushes any data buffered by the sink, called once at the end of each log_flush() */
+        virtual void              flush() {}
+    };
+
+    /* Writes formatted batches to an Arduino stream such as Serial */
+    class log_sink_serial_c : public log_sink_c
+    {
+      private:
+        Print &output;
+
+      public:
+        log_sink_serial_c(Print &serial_output) : output(serial_output) {}
+
+        void write(const log_sink_batch_s *batch);
+        void flush();
+    };
+
+    /* Longest time a partial binary log block is held before flush() syncs it, bounding the log lost on a crash */
+    #ifndef SL_ROBOT_LOG_SINK_BINARY_SYNC_PERIOD_MS
+    #define SL_ROBOT_LOG_SINK_BINARY_SYNC_PERIOD_MS 1000
+    #endif
+
+    /* Writes batches in the binary log file format (sl_robot_log_file.hpp) to an Arduino stream such as an SD card file.
+        Blocks are written once full or when sync() is called.  flush(), called at the end of every log_flush(), 
+          syncs the partial block once it holds an ERROR entry or its first entry is SL_ROBOT_LOG_SINK_BINARY_SYNC_PERIOD_MS old */
+    class log_sink_binary_file_c : public log_sink_c
+    {
+      private:
+        /* Format strings remembered per block, further strings are repeated */
+        static constexpr size_t BLOCK_FORMATS = 16;
+
+        Print &output;
+        bool   header_written;
+
+        /* Entry time extended to 64 bits */
+        log_file_time_t time;
+
+        /* Block being built */
+        uint8_t     block[SL_ROBOT_LOG_FILE_BLOCK_SIZE] __attribute__((aligned(4)));
+        uint32_t    block_sequence;
+        const char *block_formats[BLOCK_FORMATS];
+        size_t      block_format_count;
+        /* Current block holds an ERROR entry */
+        bool        block_has_error;
+
+        inline log_file_block_header_s * block_header() {return (log_file_block_header_s *) block;}
+        /* Returns 'true' if the format string is already defined in the current block */
+        bool block_has_format(const char *) const;
+        /* Returns 'true' if a record of length may be appended at time */
+        bool block_fits(size_t length, log_file_time_t record_time);
+        void block_append(log_file_record_type_e, uint8_t key, uint8_t level, int32_t time_offset, 
+                          const void *body, size_t body_length, const void *body_tail = nullptr, size_t body_tail_length = 0);
+        void block_reset();
+        void block_write();
+        void write_entry(const log_sink_record_s *);
+
+      public:
+        log_sink_binary_file_c(Print &file_output);
+
+        log_sink_format_e format() const {return LOG_SINK_FORMAT_BINARY;}
+        void              write(const log_sink_batch_s *batch);
+        /* Syncs per the policy above, otherwise only flushes the stream */
+        void              flush();
+        /* Writes the current partial block, padded to full size, and flushes the stream */
+        void              sync();
+    };
+
+    #if defined(__unix__)
+    /* Writes batches to a host file descriptor with one writev() per batch.
+        Binary records are written as a 16-bit little endian length followed by the raw log entry */
+    class log_sink_file_c : public log_sink_c
+    {
+      private:
+        const int               file_descriptor;
+        const log_sink_format_e file_format;
+
+      public:
+        log_sink_file_c(int fd, log_sink_format_e fd_format = LOG_SINK_FORMAT_TEXT)
+          : file_descriptor(fd), file_format(fd_format) {}
+
+        log_sink_format_e format() const {return file_format;}
+        void              write(const log_sink_batch_s *batch);
+    };
+    #endif
+
+    /* Captures formatted text in memory, for tests.  Text beyond capacity is dropped */
+    class log_sink_memory_c : public log_sink_c
+    {
+      private:
+        const size_t capacity;
+        char        *capture_buffer;
+        size_t       captured_length;
+        size_t       captured_records;
+        size_t       dropped_length;
+
+      public:
+        log_sink_memory_c(size_t capacity);
+        ~log_sink_memory_c();
+
+        void write(const log_sink_batch_s *batch);
+
+        /* Captured text, null terminated */
+        inline const char * text()    const {return capture_buffer;}
+        inline size_t       length()  const {return captured_length;}
+        inline size_t       records() const {return captured_records;}
+        inline size_t       dropped() const {return dropped_length;}
+        void                clear();
+    };
+
+    /* Discards all records, for benchmarking the logging path */
+    class log_sink_null_c : public log_sink_c
+    {
+      private:
+        const log_sink_format_e sink_format;
+        size_t                  discarded_records;
+        size_t                  discarded_batches;
+
+      public:
+        log_sink_null_c(log_sink_format_e null_format = LOG_SINK_FORMAT_TEXT)
+          : sink_format(null_format), discarded_records(0), discarded_batches(0) {}
+
+        log_sink_format_e format() const {return sink_format;}
+        void              write(const log_sink_batch_s *batch) {discarded_records += batch->count; discarded_batches++;}
+
+        inline size_t     records() const {return discarded_records;}
+        inline size_t     batches() const {return discarded_batches;}
+    };
+  }
+}
+
+#endif /* __SL_ROBOT_LOG_SINK_HPP__ */
@@ -12,6 +12,7 @@
 #include <task.h>
 
 #include "sl_robot_log.hpp"
+#include "sl_robot_log_sink.hpp"
 
 namespace sandor_laboratories
 {
@@ -19,6 +20,8 @@ namespace sandor_laboratories
   {
     void log_init(const TaskHandle_t * log_task_handle, log_level_e);
     void log_flush();
+    /* Changes sink entries are written to by log_flush().  Defaults to Serial */
+    void log_set_sink(log_sink_c *);
   }
 }
 
@@ -0,0 +1,31 @@
+/*
+  sl_robot_static_circular_buffer.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_ROBOT_STATIC_CIRCULAR_BUFFER_HPP__
+#define __SL_ROBOT_STATIC_CIRCULAR_BUFFER_HPP__
+
+#include "sl_robot_circular_buffer.hpp"
+#include "sl_robot_circular_buffer_core.hpp"
+
+namespace sandor_laboratories
+{
+  namespace robot
+  {
+    /* Circular buffer with compile-time capacity and inline storage.
+        Matches the circular_buffer_c interface (both share circular_buffer_core_c), but never touches the heap and can be 
+        constant initialized so a static instance lives in .bss.  N must be a power of 2 so index wrapping is a constant mask.
+        As mutexes cannot be created before the scheduler, a mutex is only used once init_mutex() is called. */
+    template <typename T, circular_buffer_index_t N>
+    class static_circular_buffer_c : public circular_buffer_core_c<T, circular_buffer_inline_storage_c<T, N>>
+    {
+      public:
+        constexpr static_circular_buffer_c() : circular_buffer_core_c<T, circular_buffer_inline_storage_c<T, N>>() {}
+    };
+  }
+}
+
+#endif /* __SL_ROBOT_STATIC_CIRCULAR_BUFFER_HPP__ */
@@ -14,11 +14,19 @@ namespace sandor_laboratories
   {
     /* Time type (ms) */
     typedef unsigned long time_ms_t;
+    /* Time type (us) */
+    typedef uint64_t      time_us_t;
 
     /* Velocity type */
     typedef int           velocity_t;
     /* RPM type */
     typedef int           rpm_t;
+    /* Fixed-point RPM type (RPM * 2^RPM_FIXED_FRACTION_BITS) */
+    enum
+    {
+      RPM_FIXED_FRACTION_BITS = 8
+    };
+    typedef int32_t       rpm_fixed_t;
 
     /* Hardware Pin Type */
     enum
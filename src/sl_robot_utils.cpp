@@ -58,7 +58,7 @@ void sandor_laboratories::robot::mutex_deinit(mutex_handle_t* mutex_handle)
 {
   ASSERT(mutex_handle);
   vSemaphoreDelete(*mutex_handle);
-  ASSERT(nullptr==*mutex_handle);
+  *mutex_handle = nullptr;
 }
 void sandor_laboratories::robot::mutex_lock(mutex_handle_t* mutex_handle)
 {
@@ -71,6 +71,54 @@ void sandor_laboratories::robot::mutex_unlock(mutex_handle_t* mutex_handle)
   ASSERT(pdTRUE == xSemaphoreGive(*mutex_handle));
 }
 
+task_handle_t sandor_laboratories::robot::task_get_current()
+{
+  return xTaskGetCurrentTaskHandle();
+}
+static_assert((SL_ROBOT_NOTIFY_INDEX_DEFAULT < configTASK_NOTIFICATION_ARRAY_ENTRIES) &&
+              (SL_ROBOT_NOTIFY_INDEX_BUFFER  < configTASK_NOTIFICATION_ARRAY_ENTRIES),
+              "configTASK_NOTIFICATION_ARRAY_ENTRIES too small for SL_ROBOT_NOTIFY_INDEX_*");
+void sandor_laboratories::robot::task_notify(task_handle_t task_handle, unsigned int index)
+{
+  ASSERT(task_handle);
+  if(xPortIsInsideInterrupt() == pdTRUE)
+  {
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveIndexedFromISR(task_handle, index, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+  }
+  else
+  {
+    xTaskNotifyGiveIndexed(task_handle, index);
+  }
+}
+bool sandor_laboratories::robot::task_notify_wait(time_ms_t timeout, unsigned int index)
+{
+  const TickType_t timeout_ticks = (SL_ROBOT_WAIT_FOREVER == timeout) ? portMAX_DELAY : pdMS_TO_TICKS(timeout);
+  return (0 != ulTaskNotifyTakeIndexed(index, pdTRUE, timeout_ticks));
+}
+bool sandor_laboratories::robot::task_context()
+{
+  return ((xPortIsInsideInterrupt() != pdTRUE) && (taskSCHEDULER_NOT_STARTED != xTaskGetSchedulerState()));
+}
+bool sandor_laboratories::robot::interrupt_context()
+{
+  return (xPortIsInsideInterrupt() == pdTRUE);
+}
+void sandor_laboratories::robot::task_sleep()
+{
+  vTaskDelay(1);
+}
+void* sandor_laboratories::robot::task_local_storage_get(unsigned int index)
+{
+  ASSERT(index < configNUM_THREAD_LOCAL_STORAGE_POINTERS);
+  return pvTaskGetThreadLocalStoragePointer(nullptr, index);
+}
+void sandor_laboratories::robot::task_local_storage_set(unsigned int index, void * value)
+{
+  ASSERT(index < configNUM_THREAD_LOCAL_STORAGE_POINTERS);
+  vTaskSetThreadLocalStoragePointer(nullptr, index, value);
+}
 
 void* sandor_laboratories::robot::heap_malloc(size_t size)
 {
@@ -13,6 +13,9 @@
 /* FreeRTOS Includes */
 #include <arduino_freertos.h>
 #include <semphr.h>
+#include <task.h>
+
+#include "sl_robot_types.hpp"
 
 namespace sandor_laboratories
 {
@@ -20,6 +23,11 @@ namespace sandor_laboratories
   { 
     #define ASSERT(condition) assert(condition)
 
+    /* Data cache line size in bytes (Cortex-M7), used to keep independently written data apart */
+    #ifndef SL_ROBOT_CACHE_LINE_SIZE
+    #define SL_ROBOT_CACHE_LINE_SIZE 32
+    #endif
+
     /* Heap Malloc and Free */
     void* heap_malloc(size_t);
     void  heap_free(void *);
@@ -38,6 +46,32 @@ namespace sandor_laboratories
     void mutex_lock  (mutex_handle_t*);
     void mutex_unlock(mutex_handle_t*);
 
+    /* Utility functions to signal and wait on task notifications */
+    #define SL_ROBOT_WAIT_FOREVER ((time_ms_t) ~0UL)
+    typedef TaskHandle_t task_handle_t;
+    /* Notification indices, so library waits never consume notifications meant for the task itself.
+        Requires configTASK_NOTIFICATION_ARRAY_ENTRIES greater than every index used */
+    #ifndef SL_ROBOT_NOTIFY_INDEX_DEFAULT
+    #define SL_ROBOT_NOTIFY_INDEX_DEFAULT 0
+    #endif
+    #ifndef SL_ROBOT_NOTIFY_INDEX_BUFFER
+    #define SL_ROBOT_NOTIFY_INDEX_BUFFER  1
+    #endif
+    task_handle_t task_get_current();
+    /* Notify task on notification index, may be called from tasks or interrupts */
+    void task_notify(task_handle_t, unsigned int index=SL_ROBOT_NOTIFY_INDEX_DEFAULT);
+    /* Block calling task until notified on notification index or timeout (ms) expires.  Returns 'true' if notified */
+    bool task_notify_wait(time_ms_t timeout, unsigned int index=SL_ROBOT_NOTIFY_INDEX_DEFAULT);
+    /* Returns 'true' if called from a running task, 'false' from interrupts or before the scheduler starts */
+    bool task_context();
+    /* Returns 'true' if called from an interrupt */
+    bool interrupt_context();
+    /* Block calling task for at least one tick, so tasks of any priority may run */
+    void task_sleep();
+    /* Utility functions to get and set the calling task's thread local storage pointers.  Only valid in task context */
+    void* task_local_storage_get(unsigned int index);
+    void  task_local_storage_set(unsigned int index, void *);
+
   }
 }
 
@@ -0,0 +1,152 @@
+/*
+  sl_robot_velocity_estimator.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include <Arduino.h>
+#include <cmath>
+
+#include "sl_robot_utils.hpp"
+#include "sl_robot_velocity_estimator.hpp"
+
+using namespace sandor_laboratories::robot;
+
+velocity_estimator_moving_average_c::velocity_estimator_moving_average_c(size_t average_window)
+  : window(average_window)
+{
+  ASSERT((window > 0) && (window <= WINDOW_MAX));
+  reset();
+}
+void velocity_estimator_moving_average_c::reset()
+{
+  velocity_estimator_c::reset();
+  sum          = 0;
+  time         = 0;
+  index        = 0;
+  sample_count = 0;
+}
+void velocity_estimator_moving_average_c::update(rpm_fixed_t measured_rpm_fixed, time_us_t elapsed_time)
+{
+  const int32_t sample = measured_rpm_fixed;
+  time += elapsed_time;
+
+  if(sample_count == window)
+  {
+    const size_t  oldest         = index;
+    const int32_t oldest_sample  = samples[oldest];
+    const time_us_t span         = (time - sample_times[oldest]);
+
+    sum -= oldest_sample;
+    if(span)
+    {
+      acceleration = (rpm_acceleration_t) ((((int64_t) sample - oldest_sample) * 1000000) / 
+                                           ((int64_t) span * (1 << RPM_FIXED_FRACTION_BITS)));
+    }
+  }
+  else
+  {
+    sample_count++;
+  }
+
+  samples[index]      = sample;
+  sample_times[index] = time;
+  index               = ((index + 1) % window);
+  sum                += sample;
+
+  /* Round to nearest */
+  const int64_t average = (sum / (int64_t) sample_count);
+  rpm = (rpm_t) ((average + ((average >= 0) ? 1 : -1) * (1 << (RPM_FIXED_FRACTION_BITS - 1))) / (1 << RPM_FIXED_FRACTION_BITS));
+}
+
+velocity_estimator_alpha_beta_c::velocity_estimator_alpha_beta_c(float constructor_alpha, float constructor_beta)
+  : alpha(constructor_alpha), beta(constructor_beta)
+{
+  reset();
+}
+void velocity_estimator_alpha_beta_c::reset()
+{
+  velocity_estimator_c::reset();
+  velocity_estimate     = 0.0f;
+  acceleration_estimate = 0.0f;
+  initialized           = false;
+}
+void velocity_estimator_alpha_beta_c::update(rpm_fixed_t measured_rpm_fixed, time_us_t elapsed_time)
+{
+  const float dt           = ((float) elapsed_time / 1000000.0f);
+  const float measured_rpm = ((float) measured_rpm_fixed / (float) (1 << RPM_FIXED_FRACTION_BITS));
+
+  if(!initialized || (dt <= 0.0f))
+  {
+    velocity_estimate = measured_rpm;
+    initialized       = true;
+  }
+  else
+  {
+    const float predicted = velocity_estimate + (acceleration_estimate * dt);
+    const float residual  = (measured_rpm - predicted);
+
+    velocity_estimate      = predicted + (alpha * residual);
+    acceleration_estimate += ((beta / dt) * residual);
+  }
+
+  rpm          = (rpm_t) lroundf(velocity_estimate);
+  acceleration = (rpm_acceleration_t) lroundf(acceleration_estimate);
+}
+
+velocity_estimator_kalman_c::velocity_estimator_kalman_c(float constructor_jerk_noise, float constructor_measurement_noise)
+  : jerk_noise(constructor_jerk_noise), measurement_noise(constructor_measurement_noise)
+{
+  reset();
+}
+void velocity_estimator_kalman_c::reset()
+{
+  velocity_estimator_c::reset();
+  velocity_estimate     = 0.0f;
+  acceleration_estimate = 0.0f;
+  p00                   = 0.0f;
+  p01                   = 0.0f;
+  p11                   = 0.0f;
+  initialized           = false;
+}
+void velocity_estimator_kalman_c::update(rpm_fixed_t measured_rpm_fixed, time_us_t elapsed_time)
+{
+  const float dt           = ((float) elapsed_time / 1000000.0f);
+  const float measured_rpm = ((float) measured_rpm_fixed / (float) (1 << RPM_FIXED_FRACTION_BITS));
+
+  if(!initialized || (dt <= 0.0f))
+  {
+    /* Start at the measurement, acceleration unknown */
+    velocity_estimate     = measured_rpm;
+    acceleration_estimate = 0.0f;
+    p00                   = measurement_noise;
+    p01                   = 0.0f;
+    p11                   = (measurement_noise / (dt > 0.0f ? (dt * dt) : 1.0f));
+    initialized           = true;
+  }
+  else
+  {
+    /* Predict: x = F x, P = F P F' + Q with F = [1 dt; 0 1] */
+    const float dt2 = (dt * dt);
+    velocity_estimate += (acceleration_estimate * dt);
+    const float pp00 = p00 + (2.0f * dt * p01) + (dt2 * p11) + (jerk_noise * dt2 * dt / 3.0f);
+    const float pp01 = p01 + (dt * p11) + (jerk_noise * dt2 / 2.0f);
+    const float pp11 = p11 + (jerk_noise * dt);
+
+    /* Update with velocity measurement, H = [1 0] */
+    const float residual   = (measured_rpm - velocity_estimate);
+    const float innovation = (pp00 + measurement_noise);
+    const float k0         = (pp00 / innovation);
+    const float k1         = (pp01 / innovation);
+
+    velocity_estimate     += (k0 * residual);
+    acceleration_estimate += (k1 * residual);
+    p00 = ((1.0f - k0) * pp00);
+    p01 = ((1.0f - k0) * pp01);
+    p11 = (pp11 - (k1 * pp01));
+  }
+
+  rpm          = (rpm_t) lroundf(velocity_estimate);
+  acceleration = (rpm_acceleration_t) lroundf(acceleration_estimate);
+}
@@ -0,0 +1,113 @@
+/*
+  sl_robot_velocity_estimator.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#ifndef __SL_ROBOT_VELOCITY_ESTIMATOR_HPP__
+#define __SL_ROBOT_VELOCITY_ESTIMATOR_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sl_robot_types.hpp"
+
+namespace sandor_laboratories
+{
+  namespace robot
+  {
+    /* RPM Acceleration Type (RPM per second) */
+    typedef int rpm_acceleration_t;
+
+    /* Velocity estimator interface.  
+        Smooths raw per-window RPM measurements and estimates acceleration, updated once per encoder loop() */
+    class velocity_estimator_c
+    {
+      protected:
+        rpm_t              rpm;
+        rpm_acceleration_t acceleration;
+
+      public:
+        velocity_estimator_c() : rpm(0), acceleration(0) {}
+        virtual ~velocity_estimator_c() {}
+
+        /* Applies a raw RPM measurement (RPM_FIXED_FRACTION_BITS fractional bits) taken over elapsed_time (us) */
+        virtual void update(rpm_fixed_t measured_rpm_fixed, time_us_t elapsed_time) = 0;
+        /* Clears estimator state */
+        virtual void reset() {rpm = 0; acceleration = 0;}
+
+        inline rpm_t              get_rpm()          const {return rpm;}
+        inline rpm_acceleration_t get_acceleration() const {return acceleration;}
+    };
+
+    /* Moving average of the last window measurements, kept in the measurements' fixed point.
+        Acceleration is the change across the window divided by the time it spans.
+        Latency is about half the window */
+    class velocity_estimator_moving_average_c : public velocity_estimator_c
+    {
+      public:
+        static constexpr size_t WINDOW_MAX = 16;
+
+      private:
+        const size_t window;
+        int32_t      samples[WINDOW_MAX];
+        time_us_t    sample_times[WINDOW_MAX];
+        int64_t      sum;
+        time_us_t    time;
+        size_t       index;
+        size_t       sample_count;
+
+      public:
+        /* Window of 1 to WINDOW_MAX measurements */
+        velocity_estimator_moving_average_c(size_t average_window);
+
+        void update(rpm_fixed_t measured_rpm_fixed, time_us_t elapsed_time);
+        void reset();
+    };
+
+    /* Alpha-beta tracker on velocity with an acceleration state.
+        Each update predicts velocity from acceleration, then corrects velocity by alpha and acceleration by beta 
+          times the residual.  Higher alpha/beta track faster, lower smooth more.
+        0 < alpha <= 1, 0 < beta <= 2 (beta well below alpha is typical) */
+    class velocity_estimator_alpha_beta_c : public velocity_estimator_c
+    {
+      private:
+        const float alpha;
+        const float beta;
+        float       velocity_estimate;
+        float       acceleration_estimate;
+        bool        initialized;
+
+      public:
+        velocity_estimator_alpha_beta_c(float alpha, float beta);
+
+        void update(rpm_fixed_t measured_rpm_fixed, time_us_t elapsed_time);
+        void reset();
+    };
+
+    /* Constant-acceleration Kalman filter on velocity.
+        State is velocity and acceleration, driven by white jerk noise.
+        jerk_noise:       jerk spectral density (RPM^2/s^5), higher tracks faster changes
+        measurement_noise: variance of raw RPM measurements (RPM^2) */
+    class velocity_estimator_kalman_c : public velocity_estimator_c
+    {
+      private:
+        const float jerk_noise;
+        const float measurement_noise;
+        float       velocity_estimate;
+        float       acceleration_estimate;
+        /* Estimate covariance */
+        float       p00, p01, p11;
+        bool        initialized;
+
+      public:
+        velocity_estimator_kalman_c(float jerk_noise, float measurement_noise);
+
+        void update(rpm_fixed_t measured_rpm_fixed, time_us_t elapsed_time);
+        void reset();
+    };
+  }
+}
+
+#endif // __SL_ROBOT_VELOCITY_ESTIMATOR_HPP__
@@ -0,0 +1,75 @@
+/*
+  Arduino.h
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host stand-in for the Arduino/Teensy core, only what the library uses.
+  Time runs from the host monotonic clock.  ARM_DWT_CYCCNT is simulated at F_CPU_ACTUAL, 
+    so building with -D__IMXRT1062__ exercises the Teensy clock code, including counter wraps.
+  Pin levels are set by the tool with host_pin_write().
+*/
+
+#ifndef __SL_ROBOT_HOST_ARDUINO_H__
+#define __SL_ROBOT_HOST_ARDUINO_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace arduino
+{
+  enum {INPUT = 0, OUTPUT = 1, INPUT_PULLUP = 2};
+}
+using namespace arduino;
+
+#define LOW  0
+#define HIGH 1
+
+#define F_CPU 600000000
+extern uint32_t F_CPU_ACTUAL;
+
+unsigned long millis();
+unsigned long micros();
+
+void    pinMode(uint8_t pin, int mode);
+int     digitalRead(uint8_t pin);
+uint8_t digitalReadFast(uint8_t pin);
+void    digitalWrite(uint8_t pin, int value);
+void    analogWrite(uint8_t pin, int value);
+void    analogWriteFrequency(uint8_t pin, float frequency);
+
+size_t strlcpy(char *destination, const char *source, size_t size);
+
+/* DWT cycle counter */
+uint32_t host_cycle_counter();
+#define ARM_DWT_CYCCNT (host_cycle_counter())
+extern volatile uint32_t ARM_DEMCR;
+extern volatile uint32_t ARM_DWT_CTRL;
+#define ARM_DEMCR_TRCENA       (1 << 24)
+#define ARM_DWT_CTRL_CYCCNTENA (1 << 0)
+
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    virtual int    availableForWrite() {return 0;}
+    virtual void   flush() {}
+};
+
+/* Serial writes to stdout */
+class host_serial_c : public Print
+{
+  public:
+    size_t write(uint8_t);
+    size_t write(const uint8_t *buffer, size_t size);
+    int    availableForWrite();
+    void   flush();
+};
+extern host_serial_c Serial;
+
+#endif /* __SL_ROBOT_HOST_ARDUINO_H__ */
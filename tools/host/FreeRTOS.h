@@ -0,0 +1,41 @@
+/*
+  FreeRTOS.h
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host stand-in for the FreeRTOS kernel, only what the library uses.
+  Tasks are host threads.  Critical sections are one global recursive lock taken by tasks and simulated interrupts alike.
+*/
+
+#ifndef __SL_ROBOT_HOST_FREERTOS_H__
+#define __SL_ROBOT_HOST_FREERTOS_H__
+
+#include <cstddef>
+#include <cstdint>
+
+typedef long          BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t      TickType_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define portMAX_DELAY    ((TickType_t) 0xFFFFFFFFUL)
+#define pdMS_TO_TICKS(x) ((TickType_t) (x))
+
+#define configTICK_RATE_HZ                      1000
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   3
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
+
+/* 'true' on threads marked as interrupts by host_interrupt_context() */
+BaseType_t  xPortIsInsideInterrupt();
+
+void        host_critical_section_enter();
+void        host_critical_section_exit();
+#define taskENTER_CRITICAL()            host_critical_section_enter()
+#define taskEXIT_CRITICAL()             host_critical_section_exit()
+#define taskENTER_CRITICAL_FROM_ISR()   (host_critical_section_enter(), (UBaseType_t) 0)
+#define taskEXIT_CRITICAL_FROM_ISR(x)   ((void) (x), host_critical_section_exit())
+#define portYIELD_FROM_ISR(x)           ((void) (x))
+
+#endif /* __SL_ROBOT_HOST_FREERTOS_H__ */
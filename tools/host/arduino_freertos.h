@@ -0,0 +1,17 @@
+/*
+  arduino_freertos.h
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host stand-in for the Teensy FreeRTOS port header.
+*/
+
+#ifndef __SL_ROBOT_HOST_ARDUINO_FREERTOS_H__
+#define __SL_ROBOT_HOST_ARDUINO_FREERTOS_H__
+
+#include "Arduino.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#endif /* __SL_ROBOT_HOST_ARDUINO_FREERTOS_H__ */
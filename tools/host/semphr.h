@@ -0,0 +1,23 @@
+/*
+  semphr.h
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host stand-in for FreeRTOS mutexes.
+*/
+
+#ifndef __SL_ROBOT_HOST_SEMPHR_H__
+#define __SL_ROBOT_HOST_SEMPHR_H__
+
+#include "FreeRTOS.h"
+
+typedef void * QueueHandle_t;
+typedef void * SemaphoreHandle_t;
+
+QueueHandle_t xSemaphoreCreateMutex();
+void          vSemaphoreDelete(QueueHandle_t);
+BaseType_t    xSemaphoreTake(QueueHandle_t, TickType_t);
+BaseType_t    xSemaphoreGive(QueueHandle_t);
+
+#endif /* __SL_ROBOT_HOST_SEMPHR_H__ */
@@ -0,0 +1,146 @@
+/*
+  sl_robot_host.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host stand-ins for the Arduino core and FreeRTOS, see Arduino.h and FreeRTOS.h.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Arduino.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "sl_robot_host.hpp"
+#include "task.h"
+
+/* Time */
+static const std::chrono::steady_clock::time_point host_start = std::chrono::steady_clock::now();
+static uint64_t host_elapsed_ns()
+{
+  return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - host_start).count();
+}
+
+uint32_t          F_CPU_ACTUAL = F_CPU;
+volatile uint32_t ARM_DEMCR;
+volatile uint32_t ARM_DWT_CTRL;
+
+unsigned long millis() {return (unsigned long) (host_elapsed_ns() / 1000000);}
+unsigned long micros() {return (unsigned long) (host_elapsed_ns() / 1000);}
+uint64_t host_cycle_counter_64()
+{
+  return (uint64_t) (((unsigned __int128) host_elapsed_ns() * F_CPU_ACTUAL) / 1000000000);
+}
+uint32_t host_cycle_counter() {return (uint32_t) host_cycle_counter_64();}
+
+/* Pins */
+static std::atomic<uint8_t> host_pins[256];
+void    host_pin_write(uint8_t pin, uint8_t level) {host_pins[pin].store(level ? 1 : 0, std::memory_order_relaxed);}
+void    pinMode(uint8_t, int) {}
+int     digitalRead(uint8_t pin) {return host_pins[pin].load(std::memory_order_relaxed);}
+uint8_t digitalReadFast(uint8_t pin) {return host_pins[pin].load(std::memory_order_relaxed);}
+void    digitalWrite(uint8_t pin, int value) {host_pin_write(pin, (uint8_t) value);}
+void    analogWrite(uint8_t, int) {}
+void    analogWriteFrequency(uint8_t, float) {}
+
+size_t strlcpy(char *destination, const char *source, size_t size)
+{
+  const size_t length = strlen(source);
+  if(size)
+  {
+    const size_t copy_length = (length < (size - 1)) ? length : (size - 1);
+    memcpy(destination, source, copy_length);
+    destination[copy_length] = '\0';
+  }
+  return length;
+}
+
+/* Serial */
+host_serial_c Serial;
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t written = 0;
+  while(size--)
+  {
+    written += write(*buffer++);
+  }
+  return written;
+}
+size_t host_serial_c::write(uint8_t c)                            {return (EOF != fputc(c, stdout)) ? 1 : 0;}
+size_t host_serial_c::write(const uint8_t *buffer, size_t size)   {return fwrite(buffer, 1, size, stdout);}
+int    host_serial_c::availableForWrite()                         {return 4096;}
+void   host_serial_c::flush()                                     {fflush(stdout);}
+
+/* Interrupts and critical sections */
+static thread_local bool      host_in_interrupt;
+static std::recursive_mutex   host_critical_section;
+static std::atomic<uint64_t>  host_critical_sections;
+void       host_interrupt_context(bool interrupt) {host_in_interrupt = interrupt;}
+BaseType_t xPortIsInsideInterrupt() {return host_in_interrupt ? pdTRUE : pdFALSE;}
+void host_critical_section_enter()
+{
+  host_critical_section.lock();
+  host_critical_sections.fetch_add(1, std::memory_order_relaxed);
+}
+void     host_critical_section_exit() {host_critical_section.unlock();}
+uint64_t host_critical_section_count() {return host_critical_sections.load(std::memory_order_relaxed);}
+
+/* Mutexes */
+QueueHandle_t xSemaphoreCreateMutex()          {return new std::mutex();}
+void          vSemaphoreDelete(QueueHandle_t m) {delete (std::mutex *) m;}
+BaseType_t    xSemaphoreTake(QueueHandle_t m, TickType_t) {((std::mutex *) m)->lock(); return pdTRUE;}
+BaseType_t    xSemaphoreGive(QueueHandle_t m)  {((std::mutex *) m)->unlock(); return pdTRUE;}
+
+/* Tasks - every thread is a task with its own notification values and thread local storage */
+struct host_task_s
+{
+  std::mutex              lock;
+  std::condition_variable notified;
+  uint32_t                notifications[configTASK_NOTIFICATION_ARRAY_ENTRIES];
+  void                   *local_storage[configNUM_THREAD_LOCAL_STORAGE_POINTERS];
+};
+static thread_local host_task_s host_task;
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {return &host_task;}
+BaseType_t   xTaskGetSchedulerState()    {return taskSCHEDULER_RUNNING;}
+TickType_t   xTaskGetTickCount()         {return (TickType_t) millis();}
+void         vTaskDelay(TickType_t ticks)  {std::this_thread::sleep_for(std::chrono::milliseconds(ticks));}
+
+void xTaskNotifyGiveIndexed(TaskHandle_t task, UBaseType_t index)
+{
+  std::lock_guard<std::mutex> guard(task->lock);
+  task->notifications[index]++;
+  task->notified.notify_all();
+}
+void vTaskNotifyGiveIndexedFromISR(TaskHandle_t task, UBaseType_t index, BaseType_t *higher_priority_task_woken)
+{
+  xTaskNotifyGiveIndexed(task, index);
+  *higher_priority_task_woken = pdFALSE;
+}
+uint32_t ulTaskNotifyTakeIndexed(UBaseType_t index, BaseType_t clear_on_exit, TickType_t timeout)
+{
+  std::unique_lock<std::mutex> guard(host_task.lock);
+  auto pending = [index] {return (0 != host_task.notifications[index]);};
+  if(portMAX_DELAY == timeout)
+  {
+    host_task.notified.wait(guard, pending);
+  }
+  else
+  {
+    host_task.notified.wait_for(guard, std::chrono::milliseconds(timeout), pending);
+  }
+  const uint32_t value = host_task.notifications[index];
+  if(value)
+  {
+    host_task.notifications[index] = clear_on_exit ? 0 : (value - 1);
+  }
+  return value;
+}
+
+void  vTaskSetThreadLocalStoragePointer(TaskHandle_t, BaseType_t index, void *value) {host_task.local_storage[index] = value;}
+void *pvTaskGetThreadLocalStoragePointer(TaskHandle_t, BaseType_t index)              {return host_task.local_storage[index];}
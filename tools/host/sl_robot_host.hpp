@@ -0,0 +1,24 @@
+/*
+  sl_robot_host.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Controls for the host stand-ins, used by tools to simulate the target.
+*/
+
+#ifndef __SL_ROBOT_HOST_HPP__
+#define __SL_ROBOT_HOST_HPP__
+
+#include <cstdint>
+
+/* Marks the calling thread as an interrupt (or back to a task) for xPortIsInsideInterrupt() */
+void     host_interrupt_context(bool interrupt);
+/* Number of critical sections entered since start, by any thread */
+uint64_t host_critical_section_count();
+/* Simulated DWT cycle count since start at F_CPU_ACTUAL, not wrapped to 32 bits.  Reference for the Teensy clock extension */
+uint64_t host_cycle_counter_64();
+/* Sets level read back by digitalRead()/digitalReadFast() */
+void     host_pin_write(uint8_t pin, uint8_t level);
+
+#endif /* __SL_ROBOT_HOST_HPP__ */
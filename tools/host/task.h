@@ -0,0 +1,33 @@
+/*
+  task.h
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host stand-in for FreeRTOS task notifications and thread local storage.
+*/
+
+#ifndef __SL_ROBOT_HOST_TASK_H__
+#define __SL_ROBOT_HOST_TASK_H__
+
+#include "FreeRTOS.h"
+
+typedef struct host_task_s * TaskHandle_t;
+
+#define taskSCHEDULER_SUSPENDED   0
+#define taskSCHEDULER_NOT_STARTED 1
+#define taskSCHEDULER_RUNNING     2
+
+TaskHandle_t xTaskGetCurrentTaskHandle();
+BaseType_t   xTaskGetSchedulerState();
+TickType_t   xTaskGetTickCount();
+void         vTaskDelay(TickType_t ticks);
+
+void         xTaskNotifyGiveIndexed(TaskHandle_t, UBaseType_t index);
+void         vTaskNotifyGiveIndexedFromISR(TaskHandle_t, UBaseType_t index, BaseType_t *higher_priority_task_woken);
+uint32_t     ulTaskNotifyTakeIndexed(UBaseType_t index, BaseType_t clear_on_exit, TickType_t timeout);
+
+void         vTaskSetThreadLocalStoragePointer(TaskHandle_t, BaseType_t index, void *value);
+void *       pvTaskGetThreadLocalStoragePointer(TaskHandle_t, BaseType_t index);
+
+#endif /* __SL_ROBOT_HOST_TASK_H__ */
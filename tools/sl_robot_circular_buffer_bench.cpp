@@ -0,0 +1,358 @@
+/*
+  sl_robot_circular_buffer_bench.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host benchmark for the circular buffers, built against the host stand-ins in tools/host.
+  One producer thread pushes log entries while one consumer thread pops them, comparing the lock-free
+    circular_buffer_spsc_c with circular_buffer_c guarded by its mutex (the buffer log_flush() used to drain).
+    A thread retries, yielding, while the buffer is full or empty, so every entry is delivered.  Reported per buffer:
+    ops/s      Entries pushed and popped per second
+    push, pop  Host time of successful calls at the 50th, 99th and 99.9th percentiles and the maximum (ns),
+                 including steady_clock overhead.  Tail latency on the host includes preemption, so compare buffers, not absolutes
+  Bulk API overhead is then measured on one thread, so only call cost is timed.  Entries are pushed and drained in batches of
+    1, 8 and 64 with push_n() (push() on the MPSC buffer, which has no push_n()) and peek_span()/pop_n(), against the per-entry
+    push() and available()/peek_ptr()/pop_void() drain log_flush() used to do.  Reported as ns/entry for the mutexed buffer and the MPSC buffer
+  Storage layout is last, push() and pop() throughput on one thread for 4 to 128 byte entries, comparing circular_buffer_c's
+    split layout (entry states in their own array, entries naturally aligned) with the packed 1 byte state header in front of
+    each entry it replaced, rebuilt here as a circular_buffer_core_c storage class.  x86 hosts load and store unaligned
+    words at little cost, so there the split layout measures at or slightly below packed (the state array is a second
+    cache line per call).  The gain is on the target, where the Cortex-M7 splits unaligned word accesses and faults on
+    unaligned multiple loads and stores, so packed copies are done a byte or halfword at a time
+
+  Build: g++ -std=gnu++17 -O2 -D__IMXRT1062__ -Ihost -I../src sl_robot_circular_buffer_bench.cpp host/sl_robot_host.cpp
+           ../src/sl_robot_utils.cpp ../src/sl_robot_circular_buffer_spsc.cpp ../src/sl_robot_circular_buffer_mpsc.cpp 
+           -lpthread -o sl_robot_circular_buffer_bench
+  Usage: sl_robot_circular_buffer_bench [entries] [size]
+    entries  Entries pushed per buffer, default 1000000
+    size     Buffer size in entries, default 64.  Bulk API runs use 128
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include <thread>
+#include <vector>
+
+#include "sl_robot_circular_buffer.hpp"
+#include "sl_robot_circular_buffer_mpsc.hpp"
+#include "sl_robot_circular_buffer_spsc.hpp"
+
+using namespace sandor_laboratories::robot;
+
+typedef std::chrono::steady_clock bench_clock_t;
+
+/* Entry sizes (bytes) for the storage layout runs */
+#define BENCH_LAYOUT_SIZES 4, 16, 64, 128
+/* Bulk API batch sizes and buffer size */
+#define BENCH_BATCH_SIZES  {1, 8, 64}
+#define BENCH_BATCH_BUFFER 128
+
+typedef struct
+{
+  double              seconds;
+  std::vector<float>  push_ns;
+  std::vector<float>  pop_ns;
+  size_t              errors;
+} bench_result_s;
+
+static inline float elapsed_ns(bench_clock_t::time_point start, bench_clock_t::time_point end)
+{
+  return std::chrono::duration<float, std::nano>(end - start).count();
+}
+
+/* Runs one producer and one consumer through buffer, consumer checks entries arrive in order */
+template <typename BUFFER_T>
+static bench_result_s run(BUFFER_T &buffer, size_t entries)
+{
+  bench_result_s result;
+  result.push_ns.reserve(entries);
+  result.pop_ns.reserve(entries);
+  result.errors = 0;
+
+  const auto start = bench_clock_t::now();
+  std::thread producer([&buffer, &result, entries]
+  {
+    log_entry_s entry = {};
+    for(size_t i = 0; i < entries; )
+    {
+      memcpy(entry.payload, &i, sizeof(i));
+      const auto call_start = bench_clock_t::now();
+      const bool pushed     = buffer.push(&entry);
+      const auto call_end   = bench_clock_t::now();
+      if(pushed)
+      {
+        result.push_ns.push_back(elapsed_ns(call_start, call_end));
+        i++;
+      }
+      else
+      {
+        std::this_thread::yield();
+      }
+    }
+  });
+  for(size_t i = 0; i < entries; )
+  {
+    const auto call_start = bench_clock_t::now();
+    const bool popped     = buffer.available();
+    log_entry_s entry;
+    if(popped)
+    {
+      entry = buffer.pop();
+    }
+    const auto call_end = bench_clock_t::now();
+    if(popped)
+    {
+      size_t sequence;
+      memcpy(&sequence, entry.payload, sizeof(sequence));
+      result.errors += (sequence != i);
+      result.pop_ns.push_back(elapsed_ns(call_start, call_end));
+      i++;
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  result.seconds = std::chrono::duration<double>(bench_clock_t::now() - start).count();
+
+  return result;
+}
+
+static float percentile(std::vector<float> &samples, double fraction)
+{
+  const size_t index = std::min((size_t) (fraction * samples.size()), (samples.size() - 1));
+  std::nth_element(samples.begin(), (samples.begin() + index), samples.end());
+  return samples[index];
+}
+
+static void report(const char *name, bench_result_s &result, size_t entries)
+{
+  std::vector<float> * const samples[] = {&result.push_ns, &result.pop_ns};
+  printf("%-20s %12.0f", name, (entries / result.seconds));
+  for(std::vector<float> *calls : samples)
+  {
+    printf("  %6.0f %6.0f %7.0f %8.0f", percentile(*calls, 0.5), percentile(*calls, 0.99), percentile(*calls, 0.999),
+           *std::max_element(calls->begin(), calls->end()));
+  }
+  printf("%s\n", result.errors ? "  FAIL" : "");
+}
+
+static inline circular_buffer_index_t push_batch(circular_buffer_c<log_entry_s> &buffer, const log_entry_s *entries, 
+                                                 circular_buffer_index_t count)
+{
+  return buffer.push_n(entries, count);
+}
+static inline circular_buffer_index_t push_batch(circular_buffer_mpsc_c<log_entry_s> &buffer, const log_entry_s *entries, 
+                                                 circular_buffer_index_t count)
+{
+  circular_buffer_index_t pushed = 0;
+  while((pushed < count) && buffer.push(&entries[pushed]))
+  {
+    pushed++;
+  }
+  return pushed;
+}
+
+/* Host time per entry (ns) pushing and draining batches with the bulk API, or per entry with batch 0 */
+template <typename BUFFER_T>
+static double batch_ns(BUFFER_T &buffer, circular_buffer_index_t batch, size_t entries)
+{
+  static log_entry_s  batch_entries[BENCH_BATCH_BUFFER];
+  volatile uint8_t    sink = 0;
+
+  const circular_buffer_index_t count = batch ? batch : 1;
+  const auto start = bench_clock_t::now();
+  for(size_t i = 0; i < entries; i += count)
+  {
+    if(batch)
+    {
+      push_batch(buffer, batch_entries, batch);
+      typename BUFFER_T::span_c spans[2];
+      const circular_buffer_index_t peeked = buffer.peek_span(&spans[0], &spans[1], batch);
+      for(const auto &span : spans)
+      {
+        for(circular_buffer_index_t entry = 0; entry < span.size(); entry++)
+        {
+          sink = span[entry].payload[0];
+        }
+      }
+      buffer.pop_n(peeked);
+    }
+    else
+    {
+      buffer.push(&batch_entries[0]);
+      while(buffer.available())
+      {
+        sink = buffer.peek_ptr()->payload[0];
+        buffer.pop_void();
+      }
+    }
+  }
+  (void) sink;
+
+  return (std::chrono::duration<double, std::nano>(bench_clock_t::now() - start).count() / entries);
+}
+
+template <typename BUFFER_T>
+static void report_batches(const char *name, BUFFER_T &buffer, size_t entries)
+{
+  printf("%-20s %10.1f", name, batch_ns(buffer, 0, entries));
+  for(circular_buffer_index_t batch : BENCH_BATCH_SIZES)
+  {
+    printf(" %10.1f", batch_ns(buffer, batch, entries));
+  }
+  printf("\n");
+}
+
+/* Entry of size bytes for the storage layout runs */
+template <size_t SIZE>
+struct bench_entry_s
+{
+  uint32_t words[SIZE / sizeof(uint32_t)];
+};
+
+/* Storage layout circular_buffer_c used before entry states were split out, a packed 1 byte state header in front of each entry.
+    Only supports the single entry calls, spans assume contiguous entries */
+template <typename T>
+class bench_packed_storage_c
+{
+  protected:
+    typedef struct __attribute__((packed))
+    {
+      circular_buffer_entry_state_e state;
+      T                             data;
+    } packed_entry_s;
+
+    /* Index the packed entries as the separate state and data arrays circular_buffer_core_c expects */
+    struct state_view_s
+    {
+      packed_entry_s *entries;
+      circular_buffer_entry_state_e& operator[](circular_buffer_index_t i) {return entries[i].state;}
+    };
+    struct data_view_s
+    {
+      packed_entry_s *entries;
+      T& operator[](circular_buffer_index_t i) {return *((T*) (((uint8_t*) &entries[i]) + offsetof(packed_entry_s, data)));}
+    };
+
+    const circular_buffer_index_t buffer_size;
+    /* Never set, kept so locking costs the same as circular_buffer_heap_storage_c without a mutex */
+    mutex_handle_t * const        mutex;
+    packed_entry_s * const        entries;
+    state_view_s                  entry_state;
+    data_view_s                   circular_buffer;
+
+    bench_packed_storage_c(circular_buffer_index_t size)
+      : buffer_size(size), mutex(nullptr), entries(new packed_entry_s[size]()), entry_state{entries}, circular_buffer{entries} {}
+    ~bench_packed_storage_c() {delete[] entries;}
+
+    inline circular_buffer_index_t wrap_index(circular_buffer_index_t index) const {return (index % buffer_size);}
+    inline bool                    has_mutex() const {return (nullptr != mutex);}
+    inline void                    lock()   {if(mutex){mutex_lock(mutex);}}
+    inline void                    unlock() {if(mutex){mutex_unlock(mutex);}}
+};
+template <typename T>
+class bench_packed_circular_buffer_c : public circular_buffer_core_c<T, bench_packed_storage_c<T>>
+{
+  public:
+    bench_packed_circular_buffer_c(circular_buffer_index_t size) : circular_buffer_core_c<T, bench_packed_storage_c<T>>(size) {}
+};
+
+/* Entries pushed and popped per second on one thread, pushing and popping half of the buffer's size entries at a time so indices wrap */
+template <typename BUFFER_T, typename T>
+static double layout_ops(BUFFER_T &buffer, size_t entries, circular_buffer_index_t size)
+{
+  T                 entry  = {};
+  volatile uint32_t sink   = 0;
+  const size_t      batch  = (size / 2);
+
+  const auto start = bench_clock_t::now();
+  for(size_t i = 0; i < entries; i += batch)
+  {
+    for(size_t j = 0; j < batch; j++)
+    {
+      entry.words[0] = (uint32_t) j;
+      buffer.push(&entry);
+    }
+    for(size_t j = 0; j < batch; j++)
+    {
+      sink = buffer.pop().words[0];
+    }
+  }
+  (void) sink;
+
+  return (entries / std::chrono::duration<double>(bench_clock_t::now() - start).count());
+}
+
+/* Buffer size is taken from the command line, a size the compiler could see would turn index wrapping into a mask for one
+    layout and not the other */
+template <size_t SIZE>
+static void report_layout(size_t entries, circular_buffer_index_t size)
+{
+  typedef bench_entry_s<SIZE> entry_t;
+
+  circular_buffer_c<entry_t>              split(size);
+  bench_packed_circular_buffer_c<entry_t> packed(size);
+  const double packed_ops = layout_ops<bench_packed_circular_buffer_c<entry_t>, entry_t>(packed, entries, size);
+  const double split_ops  = layout_ops<circular_buffer_c<entry_t>, entry_t>(split, entries, size);
+  printf("%10zu %14.0f %14.0f %8.2fx\n", SIZE, packed_ops, split_ops, (split_ops / packed_ops));
+}
+template <size_t... SIZES>
+static void report_layouts(size_t entries, circular_buffer_index_t size)
+{
+  (report_layout<SIZES>(entries, size), ...);
+}
+
+int main(int argc, char **argv)
+{
+  const size_t                  entries = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 1000000;
+  const circular_buffer_index_t size    = (argc > 2) ? strtoul(argv[2], nullptr, 0) : 64;
+
+  if((0 == entries) || (size < 2))
+  {
+    fprintf(stderr, "entries must be non-zero and size at least 2\n");
+    return 1;
+  }
+
+  printf("%-20s %12s  %-30s  %-30s\n", "", "", "push ns", "pop ns");
+  printf("%-20s %12s  %6s %6s %7s %8s  %6s %6s %7s %8s\n", "buffer", "ops/s", "p50", "p99", "p99.9", "max",
+         "p50", "p99", "p99.9", "max");
+
+  {
+    circular_buffer_c<log_entry_s> buffer(size, true);
+    bench_result_s result = run(buffer, entries);
+    report("mutex", result, entries);
+  }
+  {
+    circular_buffer_spsc_c<log_entry_s> buffer(size);
+    bench_result_s result = run(buffer, entries);
+    report("spsc", result, entries);
+  }
+
+  printf("\n%-20s %10s", "ns/entry", "per entry");
+  for(circular_buffer_index_t batch : BENCH_BATCH_SIZES)
+  {
+    char column[16];
+    snprintf(column, sizeof(column), "batch %u", batch);
+    printf(" %10s", column);
+  }
+  printf("\n");
+  {
+    circular_buffer_c<log_entry_s> buffer(BENCH_BATCH_BUFFER, true);
+    report_batches("mutex", buffer, entries);
+  }
+  {
+    circular_buffer_mpsc_c<log_entry_s> buffer(BENCH_BATCH_BUFFER);
+    report_batches("mpsc", buffer, entries);
+  }
+
+  printf("\n%10s %14s %14s %9s\n", "entry size", "packed ops/s", "split ops/s", "gain");
+  report_layouts<BENCH_LAYOUT_SIZES>(entries, size);
+
+  return 0;
+}
@@ -0,0 +1,177 @@
+/*
+  sl_robot_circular_buffer_mpsc_stress.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host stress test and throughput measurement for circular_buffer_mpsc_c, built against the host stand-ins in tools/host.
+  N producer threads log entries tagged with their producer index and sequence into one buffer, odd producers as simulated
+    interrupts (host_interrupt_context()) reserving with allocate()/commit() and even producers as tasks with push().
+    A producer retries, yielding, while the buffer is full.  A single consumer drains with peek_span()/pop_n() as log_flush() does.
+  Checks that:
+    - every entry is delivered exactly once and each producer's entries arrive in order
+    - no critical section is entered, so interrupts are never masked to reserve or commit
+  Reported per producer count: entries/s delivered and full/entry, allocations that found the buffer full per entry.
+  Producer threads share the host CPUs, so figures on a single CPU host show contention, not parallel speedup.
+
+  Build: g++ -std=gnu++17 -O2 -D__IMXRT1062__ -Ihost -I../src sl_robot_circular_buffer_mpsc_stress.cpp host/sl_robot_host.cpp
+           ../src/sl_robot_utils.cpp ../src/sl_robot_circular_buffer_mpsc.cpp -lpthread -o sl_robot_circular_buffer_mpsc_stress
+  Usage: sl_robot_circular_buffer_mpsc_stress [entries] [producers_max] [size]
+    entries        Entries logged per producer, default 200000
+    producers_max  Largest producer count, doubled from 1, default 16
+    size           Buffer size in entries, power of 2, default 64
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "sl_robot_circular_buffer_mpsc.hpp"
+#include "sl_robot_host.hpp"
+
+using namespace sandor_laboratories::robot;
+
+#define STRESS_PRODUCERS_MAX 64
+
+typedef struct
+{
+  uint32_t producer;
+  uint32_t sequence;
+} stress_tag_s;
+
+static std::atomic<uint64_t> full_count;
+
+static void producer(circular_buffer_mpsc_c<log_entry_s> *buffer, uint32_t producer_index, uint32_t entries)
+{
+  const bool interrupt = (producer_index & 1);
+  host_interrupt_context(interrupt);
+
+  uint64_t    full  = 0;
+  log_entry_s entry = {};
+  for(uint32_t i = 0; i < entries; )
+  {
+    const stress_tag_s tag = {producer_index, i};
+    bool               logged;
+    if(interrupt)
+    {
+      log_entry_s * const allocated = buffer->allocate();
+      logged = (nullptr != allocated);
+      if(logged)
+      {
+        memcpy(allocated->payload, &tag, sizeof(tag));
+        buffer->commit(allocated);
+      }
+    }
+    else
+    {
+      memcpy(entry.payload, &tag, sizeof(tag));
+      logged = buffer->push(&entry);
+    }
+
+    if(logged)
+    {
+      i++;
+    }
+    else
+    {
+      full++;
+      std::this_thread::yield();
+    }
+  }
+  full_count.fetch_add(full, std::memory_order_relaxed);
+  host_interrupt_context(false);
+}
+
+/* Returns number of errors found */
+static size_t run(uint32_t producers, uint32_t entries, circular_buffer_index_t size)
+{
+  circular_buffer_mpsc_c<log_entry_s> buffer(size);
+  std::vector<uint32_t>               next_sequence(producers, 0);
+  size_t                              errors = 0;
+  const uint64_t                      total  = ((uint64_t) producers * entries);
+  full_count.store(0);
+
+  const uint64_t critical_sections = host_critical_section_count();
+  const auto     start             = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for(uint32_t i = 0; i < producers; i++)
+  {
+    threads.emplace_back(producer, &buffer, i, entries);
+  }
+
+  for(uint64_t delivered = 0; delivered < total; )
+  {
+    circular_buffer_mpsc_c<log_entry_s>::span_c spans[2];
+    const circular_buffer_index_t count = buffer.peek_span(&spans[0], &spans[1], size);
+    for(const auto &span : spans)
+    {
+      for(circular_buffer_index_t i = 0; i < span.size(); i++)
+      {
+        stress_tag_s tag;
+        memcpy(&tag, span[i].payload, sizeof(tag));
+        if((tag.producer >= producers) || (tag.sequence != next_sequence[tag.producer]))
+        {
+          if(errors++ < 10)
+          {
+            printf("entry error: producer %u sequence %u\n", tag.producer, tag.sequence);
+          }
+        }
+        else
+        {
+          next_sequence[tag.producer]++;
+        }
+      }
+    }
+    buffer.pop_n(count);
+    delivered += count;
+    if(0 == count)
+    {
+      std::this_thread::yield();
+    }
+  }
+  for(auto &thread : threads)
+  {
+    thread.join();
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if(buffer.available())
+  {
+    errors++;
+    printf("entries delivered beyond those logged\n");
+  }
+  if(host_critical_section_count() != critical_sections)
+  {
+    errors++;
+    printf("%llu critical sections entered\n", (unsigned long long) (host_critical_section_count() - critical_sections));
+  }
+
+  printf("%9u %12.0f %11.3f %8zu\n", producers, (total / seconds), ((double) full_count.load() / total), errors);
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  const uint32_t                entries       = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 200000;
+  const uint32_t                producers_max = (argc > 2) ? strtoul(argv[2], nullptr, 0) : 16;
+  const circular_buffer_index_t size          = (argc > 3) ? strtoul(argv[3], nullptr, 0) : 64;
+
+  if((0 == entries) || (0 == producers_max) || (producers_max > STRESS_PRODUCERS_MAX) || (size < 2) || (size & (size - 1)))
+  {
+    fprintf(stderr, "entries must be non-zero, producers_max 1 to %d and size a power of 2\n", STRESS_PRODUCERS_MAX);
+    return 1;
+  }
+
+  size_t errors = 0;
+  printf("producers    entries/s  full/entry   errors\n");
+  for(uint32_t producers = 1; producers <= producers_max; producers *= 2)
+  {
+    errors += run(producers, entries, size);
+  }
+  printf("%s\n", errors ? "FAIL" : "PASS");
+
+  return (errors ? 1 : 0);
+}
@@ -0,0 +1,170 @@
+/*
+  sl_robot_circular_buffer_wait_bench.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host benchmark of consumer wakeups and CPU for circular_buffer_c's blocking waits against polling,
+    built against the host stand-ins in tools/host.
+  A producer thread pushes entries at a steady rate into a mutexed buffer while a consumer thread drains it with:
+    poll yield   available()/pop() in a loop, yielding when empty (busy polling)
+    poll 1ms     Drains, then vTaskDelay(1), as a periodic log task would
+    wait N       wait_available(timeout, N), sleeping on its task notification until N entries are available
+  Reported per consumer:
+    wakeups/s    Consumer loop iterations per second, each a return from yield, delay or wait
+    cpu %        Consumer thread CPU time over the run
+    latency us   Mean and maximum time from push to pop.  Waits above 1 hold the last entries until the timeout when the producer stops,
+                   which sets their maximum
+  The host kernel schedules threads, not FreeRTOS, so compare consumers rather than absolute figures.
+
+  Build: g++ -std=gnu++17 -O2 -D__IMXRT1062__ -Ihost -I../src sl_robot_circular_buffer_wait_bench.cpp host/sl_robot_host.cpp
+           ../src/sl_robot_utils.cpp -lpthread -o sl_robot_circular_buffer_wait_bench
+  Usage: sl_robot_circular_buffer_wait_bench [rate] [seconds] [size]
+    rate     Entries pushed per second, default 1000
+    seconds  Run time per consumer, default 2
+    size     Buffer size in entries, default 64
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+
+#include "sl_robot_circular_buffer.hpp"
+
+using namespace sandor_laboratories::robot;
+
+typedef std::chrono::steady_clock bench_clock_t;
+
+/* Wait timeout (ms), so a waiting consumer sees the producer stop */
+#define BENCH_WAIT_TIMEOUT_MS 100
+
+typedef enum
+{
+  CONSUMER_POLL_YIELD,
+  CONSUMER_POLL_DELAY,
+  CONSUMER_WAIT,
+} consumer_e;
+
+typedef struct
+{
+  uint64_t wakeups;
+  uint64_t entries;
+  double   cpu_seconds;
+  double   latency_sum_us;
+  double   latency_max_us;
+} consumer_result_s;
+
+static std::atomic<bool> producing;
+
+static double thread_cpu_seconds()
+{
+  struct timespec time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return (time.tv_sec + (time.tv_nsec / 1e9));
+}
+
+static void producer(circular_buffer_c<log_entry_s> *buffer, uint32_t rate, double seconds)
+{
+  const auto  start    = bench_clock_t::now();
+  const auto  interval = std::chrono::duration<double>(1.0 / rate);
+  log_entry_s entry    = {};
+  for(uint64_t i = 0; i < (uint64_t) (rate * seconds); i++)
+  {
+    std::this_thread::sleep_until(start + std::chrono::duration_cast<bench_clock_t::duration>(interval * (double) i));
+    const auto now = bench_clock_t::now();
+    memcpy(entry.payload, &now, sizeof(now));
+    while(!buffer->push(&entry))
+    {
+      std::this_thread::yield();
+    }
+  }
+  producing.store(false);
+}
+
+/* Pops all available entries, accumulating latency */
+static void drain(circular_buffer_c<log_entry_s> *buffer, consumer_result_s *result)
+{
+  while(buffer->available())
+  {
+    const log_entry_s entry = buffer->pop();
+    bench_clock_t::time_point pushed;
+    memcpy(&pushed, entry.payload, sizeof(pushed));
+    const double latency_us = std::chrono::duration<double, std::micro>(bench_clock_t::now() - pushed).count();
+    result->latency_sum_us += latency_us;
+    result->latency_max_us  = (latency_us > result->latency_max_us) ? latency_us : result->latency_max_us;
+    result->entries++;
+  }
+}
+
+static consumer_result_s run(consumer_e consumer, circular_buffer_index_t watermark, uint32_t rate, double seconds,
+                             circular_buffer_index_t size)
+{
+  circular_buffer_c<log_entry_s> buffer(size, true);
+  consumer_result_s              result = {};
+
+  producing.store(true);
+  const double cpu_start = thread_cpu_seconds();
+  std::thread  producer_thread(producer, &buffer, rate, seconds);
+  while(producing.load() || buffer.available())
+  {
+    switch(consumer)
+    {
+      case CONSUMER_POLL_YIELD:
+        std::this_thread::yield();
+        break;
+      case CONSUMER_POLL_DELAY:
+        vTaskDelay(1);
+        break;
+      case CONSUMER_WAIT:
+        buffer.wait_available(BENCH_WAIT_TIMEOUT_MS, watermark);
+        break;
+    }
+    result.wakeups++;
+    drain(&buffer, &result);
+  }
+  result.cpu_seconds = (thread_cpu_seconds() - cpu_start);
+  producer_thread.join();
+
+  return result;
+}
+
+int main(int argc, char **argv)
+{
+  const uint32_t                rate    = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 1000;
+  const double                  seconds = (argc > 2) ? strtod(argv[2], nullptr)     : 2.0;
+  const circular_buffer_index_t size    = (argc > 3) ? strtoul(argv[3], nullptr, 0) : 64;
+
+  if((0 == rate) || (seconds <= 0.0) || (size < 8))
+  {
+    fprintf(stderr, "rate and seconds must be positive and size at least 8\n");
+    return 1;
+  }
+
+  const struct
+  {
+    const char              *name;
+    consumer_e               consumer;
+    circular_buffer_index_t  watermark;
+  } consumers[] =
+  {
+    {"poll yield", CONSUMER_POLL_YIELD, 0},
+    {"poll 1ms",   CONSUMER_POLL_DELAY, 0},
+    {"wait 1",     CONSUMER_WAIT,       1},
+    {"wait 8",     CONSUMER_WAIT,       8},
+  };
+
+  printf("%u entries/s for %.1fs\n", rate, seconds);
+  printf("%-12s %10s %8s %12s %12s %10s\n", "consumer", "wakeups/s", "cpu %", "latency us", "max us", "entries");
+  for(const auto &entry : consumers)
+  {
+    const consumer_result_s result = run(entry.consumer, entry.watermark, rate, seconds, size);
+    printf("%-12s %10.0f %8.2f %12.1f %12.1f %10llu\n", entry.name, (result.wakeups / seconds),
+           ((100.0 * result.cpu_seconds) / seconds), (result.entries ? (result.latency_sum_us / result.entries) : 0.0),
+           result.latency_max_us, (unsigned long long) result.entries);
+  }
+
+  return 0;
+}
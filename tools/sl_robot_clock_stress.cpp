@@ -0,0 +1,153 @@
+/*
+  sl_robot_clock_stress.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host stress test for the lock-free Teensy clock and encoder sampling path.
+  Builds the Teensy clock code (-D__IMXRT1062__) against the host stand-ins in tools/host, whose simulated cycle counter
+    runs at F_CPU_ACTUAL, raised here so the 32-bit counter wraps about once a second.
+  Simulated interrupt threads read the clock and sample an encoder while task threads read the clock, run encoder loop()
+    and read position, and one task sleeps across several counter wraps between reads.  Checks that:
+    - every clock reading lies between the true cycle count before and after it, and readings never go backwards per thread
+    - encoder counts are never lost
+    - no critical section is entered once running, so interrupts are never masked to read the clock or counts
+
+  Build: g++ -std=gnu++17 -O2 -D__IMXRT1062__ -Ihost -I../src sl_robot_clock_stress.cpp host/sl_robot_host.cpp 
+           ../src/sl_robot_clock.cpp ../src/sl_robot_utils.cpp ../src/sl_robot_encoder.cpp ../src/sl_robot_velocity_estimator.cpp 
+           -lpthread -o sl_robot_clock_stress
+  Usage: sl_robot_clock_stress [seconds] [cpu_hz]
+    seconds  Test duration, default 10
+    cpu_hz   Simulated cycle counter frequency, default 4000000000 (counter wraps every ~1.07s)
+*/
+
+#include <Arduino.h>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "sl_robot_clock.hpp"
+#include "sl_robot_encoder.hpp"
+#include "sl_robot_host.hpp"
+
+using namespace sandor_laboratories::robot;
+
+#define INTERRUPT_THREADS 2
+#define TASK_THREADS      2
+
+static std::atomic<bool>     running;
+static std::atomic<uint64_t> clock_reads;
+static std::atomic<uint64_t> clock_errors;
+
+/* Reads the clock, checking it against the reference cycle count and the thread's previous reading */
+static void clock_check(clock_ticks_t *last_ticks)
+{
+  const uint64_t      before = host_cycle_counter_64();
+  const clock_ticks_t ticks  = clock_ticks();
+  const uint64_t      after  = host_cycle_counter_64();
+
+  if((ticks < before) || (ticks > after) || (ticks < *last_ticks))
+  {
+    if(clock_errors.fetch_add(1) < 10)
+    {
+      printf("clock error: %" PRIu64 " not in [%" PRIu64 ", %" PRIu64 "], last %" PRIu64 "\n", 
+             (uint64_t) ticks, before, after, (uint64_t) *last_ticks);
+    }
+  }
+  *last_ticks = ticks;
+  clock_reads.fetch_add(1, std::memory_order_relaxed);
+}
+
+int main(int argc, char **argv)
+{
+  const double   seconds = (argc > 1) ? atof(argv[1]) : 10.0;
+  const uint32_t cpu_hz  = (argc > 2) ? (uint32_t) strtoul(argv[2], nullptr, 0) : 4000000000UL;
+
+  F_CPU_ACTUAL = cpu_hz;
+  clock_init();
+
+  encoder_c encoder(0, 1, false, 12);
+  encoder.set_period_estimation(4);
+
+  /* All setup done, nothing below may enter a critical section */
+  const uint64_t critical_sections = host_critical_section_count();
+  running = true;
+
+  std::vector<std::thread> threads;
+  std::atomic<int64_t>     edges_applied(0);
+  for(int i = 0; i < INTERRUPT_THREADS; i++)
+  {
+    threads.emplace_back([i, &encoder, &edges_applied]
+    {
+      /* Forward quadrature sequence */
+      static const encoder_channel_state_t states[4] = {0b00, 0b10, 0b11, 0b01};
+      unsigned int  state      = 0;
+      clock_ticks_t last_ticks = 0;
+      host_interrupt_context(true);
+      while(running)
+      {
+        clock_check(&last_ticks);
+        /* Only the first interrupt samples, edges are serialized like a single pin interrupt */
+        if(0 == i)
+        {
+          state = ((state + 1) & 0b11);
+          encoder.sample_state(states[state]);
+          edges_applied++;
+        }
+        std::this_thread::yield();
+      }
+    });
+  }
+  for(int i = 0; i < TASK_THREADS; i++)
+  {
+    threads.emplace_back([i, &encoder]
+    {
+      clock_ticks_t last_ticks = 0;
+      while(running)
+      {
+        clock_check(&last_ticks);
+        if(0 == i)
+        {
+          encoder.loop();
+          (void) encoder.get_position();
+        }
+        std::this_thread::yield();
+      }
+    });
+  }
+  /* Sleeps across several counter wraps, so its reads must recover the missed wraps */
+  threads.emplace_back([cpu_hz]
+  {
+    clock_ticks_t last_ticks = 0;
+    const long    wrap_ms    = (long) ((1000ULL << 32) / cpu_hz);
+    while(running)
+    {
+      clock_check(&last_ticks);
+      std::this_thread::sleep_for(std::chrono::milliseconds(3 * wrap_ms + 1));
+    }
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds((long) (seconds * 1000)));
+  running = false;
+  for(auto &thread : threads)
+  {
+    thread.join();
+  }
+  encoder.loop();
+
+  const uint64_t critical_sections_running = (host_critical_section_count() - critical_sections);
+  const uint64_t counter_wraps             = (clock_ticks() >> 32);
+  const bool     counts_ok                 = (encoder.get_position() == edges_applied);
+  const bool     passed                    = ((0 == clock_errors) && (0 == critical_sections_running) && counts_ok);
+
+  printf("clock reads %" PRIu64 ", errors %" PRIu64 ", counter wraps %" PRIu64 "\n", clock_reads.load(), clock_errors.load(), counter_wraps);
+  printf("encoder edges %" PRId64 ", position %" PRId64 ", skipped %" PRId32 "\n", 
+         edges_applied.load(), (int64_t) encoder.get_position(), (int32_t) encoder.get_skipped_count());
+  printf("critical sections while running %" PRIu64 "\n", critical_sections_running);
+  printf("%s\n", passed ? "PASS" : "FAIL");
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/*
+  sl_robot_encoder_bank_bench.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host benchmark and correctness check for encoder_bank_c, built against the host stand-ins in tools/host.
+  For 1 to 32 encoders, random quadrature motion (forward, backward, skipped and idle steps per encoder) is encoded
+    into port snapshots, with a bank per 16 encoders, each on its own port word.  Snapshots are decoded by the banks
+    (bit-parallel) and by one encoder_c per encoder through sample_state() (per-encoder), timing both.
+  Counts, skipped counts and channel states of every bank encoder must match its per-encoder reference.
+  Layouts: aligned (channel B a fixed offset from channel A, no gathering) and gathered (mixed channel offsets).
+
+  Build: g++ -std=gnu++17 -O2 -D__IMXRT1062__ -Ihost -I../src sl_robot_encoder_bank_bench.cpp host/sl_robot_host.cpp ../src/sl_robot_clock.cpp
+           ../src/sl_robot_utils.cpp ../src/sl_robot_encoder.cpp ../src/sl_robot_encoder_bank.cpp ../src/sl_robot_velocity_estimator.cpp
+           -lpthread -o sl_robot_encoder_bank_bench
+  Usage: sl_robot_encoder_bank_bench [snapshots]
+    snapshots  Port snapshots decoded per encoder count, default 200000
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "sl_robot_clock.hpp"
+#include "sl_robot_encoder.hpp"
+#include "sl_robot_encoder_bank.hpp"
+
+using namespace sandor_laboratories::robot;
+
+/* Encoders benchmarked, two banks */
+#define BENCH_ENCODERS_MAX 32
+
+/* Forward quadrature sequence */
+static const encoder_channel_state_t quadrature_states[4] = {0b00, 0b10, 0b11, 0b01};
+
+typedef enum
+{
+  LAYOUT_ALIGNED,
+  LAYOUT_GATHERED,
+} layout_e;
+
+/* Channel bits of encoder index within its bank */
+static void channel_bits(layout_e layout, size_t index, uint8_t *ch_a_bit, uint8_t *ch_b_bit)
+{
+  if(LAYOUT_ALIGNED == layout)
+  {
+    *ch_a_bit = (uint8_t) index;
+    *ch_b_bit = (uint8_t) (index + encoder_bank_c::ENCODERS_MAX);
+  }
+  else
+  {
+    /* Adjacent pairs with channel order swapped on every third encoder */
+    *ch_a_bit = (uint8_t) ((2 * index) + ((index % 3) ? 1 : 0));
+    *ch_b_bit = (uint8_t) ((2 * index) + ((index % 3) ? 0 : 1));
+  }
+}
+
+/* Returns 'true' if the bank and per-encoder decodes agree for every encoder */
+static bool run(layout_e layout, size_t encoders, size_t snapshots, double *bank_rate, double *encoder_rate)
+{
+  const size_t banks = ((encoders + encoder_bank_c::ENCODERS_MAX - 1) / encoder_bank_c::ENCODERS_MAX);
+
+  std::vector<encoder_c*>      bank_encoders;
+  std::vector<encoder_c*>      reference_encoders;
+  std::vector<encoder_bank_c*> encoder_banks;
+  uint8_t                      ch_a_bits[BENCH_ENCODERS_MAX];
+  uint8_t                      ch_b_bits[BENCH_ENCODERS_MAX];
+  bool                         ret_val = true;
+
+  for(size_t bank = 0; bank < banks; bank++)
+  {
+    encoder_banks.push_back(new encoder_bank_c());
+  }
+  for(size_t i = 0; i < encoders; i++)
+  {
+    const size_t bank_index = (i % encoder_bank_c::ENCODERS_MAX);
+    channel_bits(layout, bank_index, &ch_a_bits[i], &ch_b_bits[i]);
+    bank_encoders.push_back(new encoder_c(0, 1, false, 12));
+    reference_encoders.push_back(new encoder_c(0, 1, false, 12));
+    ret_val &= encoder_banks[i / encoder_bank_c::ENCODERS_MAX]->add(bank_encoders[i], ch_a_bits[i], ch_b_bits[i]);
+  }
+
+  /* Random motion, encoded as one port word per bank and the per-encoder channel states */
+  std::vector<encoder_port_t>          port_words(snapshots * banks, 0);
+  std::vector<encoder_channel_state_t> channel_states(snapshots * encoders, 0);
+  unsigned int                         positions[BENCH_ENCODERS_MAX] = {0};
+  uint32_t                             random = (uint32_t) ((encoders * 7) + layout + 1);
+  for(size_t snapshot = 0; snapshot < snapshots; snapshot++)
+  {
+    for(size_t i = 0; i < encoders; i++)
+    {
+      random = ((random * 1103515245) + 12345);
+      const unsigned int roll = ((random >> 16) % 16);
+      /* 5/16 forward, 4/16 backward, 1/16 skipped, rest idle */
+      const unsigned int step = (roll < 5) ? 1 : ((roll < 9) ? 3 : ((roll < 10) ? 2 : 0));
+      positions[i] = ((positions[i] + step) & 0b11);
+
+      const encoder_channel_state_t state = quadrature_states[positions[i]];
+      channel_states[(snapshot * encoders) + i] = state;
+      port_words[(snapshot * banks) + (i / encoder_bank_c::ENCODERS_MAX)] |=
+        ((((encoder_port_t) (state >> 1)) << ch_a_bits[i]) | (((encoder_port_t) (state & 0b01)) << ch_b_bits[i]));
+    }
+  }
+
+  const auto bank_start = std::chrono::steady_clock::now();
+  for(size_t snapshot = 0; snapshot < snapshots; snapshot++)
+  {
+    for(size_t bank = 0; bank < banks; bank++)
+    {
+      encoder_banks[bank]->sample(port_words[(snapshot * banks) + bank]);
+    }
+  }
+  const auto bank_end = std::chrono::steady_clock::now();
+  for(size_t snapshot = 0; snapshot < snapshots; snapshot++)
+  {
+    for(size_t i = 0; i < encoders; i++)
+    {
+      reference_encoders[i]->sample_state(channel_states[(snapshot * encoders) + i]);
+    }
+  }
+  const auto encoder_end = std::chrono::steady_clock::now();
+
+  *bank_rate    = (snapshots / std::chrono::duration<double>(bank_end - bank_start).count());
+  *encoder_rate = (snapshots / std::chrono::duration<double>(encoder_end - bank_end).count());
+
+  for(size_t i = 0; i < encoders; i++)
+  {
+    if((bank_encoders[i]->get_count()         != reference_encoders[i]->get_count()) ||
+       (bank_encoders[i]->get_skipped_count() != reference_encoders[i]->get_skipped_count()) ||
+       (bank_encoders[i]->get_state()         != reference_encoders[i]->get_state()))
+    {
+      printf("mismatch: encoder %zu count %ld/%ld skipped %ld/%ld\n", i,
+             (long) bank_encoders[i]->get_count(), (long) reference_encoders[i]->get_count(),
+             (long) bank_encoders[i]->get_skipped_count(), (long) reference_encoders[i]->get_skipped_count());
+      ret_val = false;
+    }
+    delete bank_encoders[i];
+    delete reference_encoders[i];
+  }
+  for(encoder_bank_c *bank : encoder_banks)
+  {
+    delete bank;
+  }
+
+  return ret_val;
+}
+
+int main(int argc, char **argv)
+{
+  const size_t snapshots = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 200000;
+  bool         passed    = true;
+
+  clock_init();
+
+  printf("layout    encoders banks  bank snapshots/s  per-encoder snapshots/s  speedup  match\n");
+  for(layout_e layout : {LAYOUT_ALIGNED, LAYOUT_GATHERED})
+  {
+    for(size_t encoders = 1; encoders <= BENCH_ENCODERS_MAX; encoders++)
+    {
+      double     bank_rate;
+      double     encoder_rate;
+      const bool match = run(layout, encoders, snapshots, &bank_rate, &encoder_rate);
+      passed &= match;
+      printf("%-9s %8zu %5zu %17.0f %24.0f %8.2f  %s\n", (LAYOUT_ALIGNED == layout) ? "aligned" : "gathered", encoders,
+             ((encoders + encoder_bank_c::ENCODERS_MAX - 1) / encoder_bank_c::ENCODERS_MAX), bank_rate, encoder_rate,
+             (bank_rate / encoder_rate), match ? "yes" : "NO");
+    }
+  }
+  printf("%s\n", passed ? "PASS" : "FAIL");
+
+  return passed ? 0 : 1;
+}
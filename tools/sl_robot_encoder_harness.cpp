@@ -0,0 +1,349 @@
+/*
+  sl_robot_encoder_harness.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host throughput and accuracy harness for encoder_c, built against the host stand-ins in tools/host.
+  A quadrature_generator_c waveform drives the encoder pins (host_pin_write()) and encoder_c::sample_channels() decodes
+    them in simulated interrupt context, with the waveform in simulated time so results do not depend on host load.
+  Two sampling schemes are simulated:
+    Edge interrupt  Every edge raises a pin interrupt.  The interrupt reads the pins on entry and is busy for isr_ns,
+                      edges while busy raise one more interrupt, so edges closer than isr_ns are coalesced
+    Polled          Pins are sampled every 1/sample_hz seconds
+  Reported for each scheme:
+    A sweep of edge rates with the decoded count, its error against the generated count and skipped_count
+    Max sustainable edge rate, the highest rate decoded without a skipped or lost edge, with the RPM it allows
+    Dropped edge behaviour at half the sustainable rate, where each isolated dropped edge should be one skipped edge
+      (both channels seen changing at once, counted as 0) and the count short by two edges per drop
+  Interrupt cost on the host (sample_channels() and the pin writes per edge) is measured first and used as isr_ns unless given,
+    pass the measured target interrupt time for target numbers.
+  Decoder cost is compared first against the switch based decoder encoder_c used before its lookup table, as edges/s on the host for
+    generated edges (every sample an edge, pins read as in an interrupt) and for a polled random walk (half the samples unchanged,
+    the rest a step either way, so direction is unpredictable)
+
+  Build: g++ -std=gnu++17 -O2 -D__IMXRT1062__ -Ihost -I../src sl_robot_encoder_harness.cpp sl_robot_quadrature_generator.cpp
+           host/sl_robot_host.cpp ../src/sl_robot_clock.cpp ../src/sl_robot_utils.cpp ../src/sl_robot_encoder.cpp
+           ../src/sl_robot_velocity_estimator.cpp -lpthread -o sl_robot_encoder_harness
+  Usage: sl_robot_encoder_harness [isr_ns] [sample_hz] [jitter] [drop_probability] [counts_per_revolution]
+    isr_ns                 Interrupt service time (ns), default 0 uses the measured host cost
+    sample_hz              Polled sampling rate, default 100000
+    jitter                 Edge interval jitter as a fraction of the nominal interval, default 0.2
+    drop_probability       Probability of each edge being dropped in the dropped edge run, default 0.001
+    counts_per_revolution  Encoder counts per revolution for RPM figures, default 12
+*/
+
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include <random>
+#include <vector>
+
+#include "sl_robot_clock.hpp"
+#include "sl_robot_encoder.hpp"
+#include "sl_robot_host.hpp"
+#include "sl_robot_quadrature_generator.hpp"
+
+using namespace sandor_laboratories::robot;
+
+/* Simulated encoder pins */
+#define HARNESS_CH_A_PIN 2
+#define HARNESS_CH_B_PIN 3
+/* Edges generated per run */
+#define HARNESS_EDGES    1000000
+/* Edges timed for the host interrupt cost */
+#define HARNESS_COST_EDGES 10000000
+/* Samples in the polled random walk for the decoder comparison */
+#define HARNESS_WALK_SAMPLES 1000000
+
+typedef enum
+{
+  SCHEME_EDGE_INTERRUPT,
+  SCHEME_POLLED,
+} scheme_e;
+
+typedef struct
+{
+  encoder_count_t expected_count;
+  encoder_count_t count;
+  encoder_count_t skipped_count;
+  encoder_count_t dropped_count;
+} harness_result_s;
+
+typedef struct
+{
+  scheme_e  scheme;
+  time_ns_t isr_ns;
+  uint32_t  sample_hz;
+  float     jitter;
+} harness_config_s;
+
+/* Drives the encoder pins with a channel state */
+static inline void pins_write(encoder_channel_state_t state)
+{
+  host_pin_write(HARNESS_CH_A_PIN, (state >> 1) & 1);
+  host_pin_write(HARNESS_CH_B_PIN, state & 1);
+}
+
+/* Switch based decoder encoder_c used before its lookup table, as a baseline.  Counters are atomics as in encoder_c */
+class baseline_decoder_c
+{
+  private:
+    const pin_t                          ch_a_pin;
+    const pin_t                          ch_b_pin;
+    std::atomic<encoder_channel_state_t> channel_state;
+    std::atomic<encoder_count_t>         count;
+    std::atomic<encoder_count_t>         skipped_count;
+
+    inline void step(bool forward, bool backward)
+    {
+      if(forward)
+      {
+        count.fetch_add(1, std::memory_order_relaxed);
+      }
+      else if(backward)
+      {
+        count.fetch_sub(1, std::memory_order_relaxed);
+      }
+      else
+      {
+        skipped_count.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+  public:
+    baseline_decoder_c(pin_t ch_a, pin_t ch_b) : ch_a_pin(ch_a), ch_b_pin(ch_b), count(0), skipped_count(0)
+    {
+      channel_state = ((digitalReadFast(ch_a_pin) << 1) | digitalReadFast(ch_b_pin));
+    }
+
+    void sample_channels()
+    {
+      sample_state((digitalReadFast(ch_a_pin) << 1) | digitalReadFast(ch_b_pin));
+    }
+    void sample_state(encoder_channel_state_t new_channel_state)
+    {
+      const encoder_channel_state_t old_channel_state = channel_state.load(std::memory_order_relaxed);
+      if(old_channel_state != new_channel_state)
+      {
+        /* 0b00->0b10->0b11->0b01->0b00 */
+        switch(old_channel_state)
+        {
+          case 0b00: step((0b10 == new_channel_state), (0b01 == new_channel_state)); break;
+          case 0b10: step((0b11 == new_channel_state), (0b00 == new_channel_state)); break;
+          case 0b11: step((0b01 == new_channel_state), (0b10 == new_channel_state)); break;
+          case 0b01: step((0b00 == new_channel_state), (0b11 == new_channel_state)); break;
+          default: break;
+        }
+        channel_state.store(new_channel_state, std::memory_order_relaxed);
+      }
+    }
+
+    encoder_count_t get_count()         const {return count.load(std::memory_order_relaxed);}
+    encoder_count_t get_skipped_count() const {return skipped_count.load(std::memory_order_relaxed);}
+};
+
+/* Host time (ns) of one edge interrupt, pin writes included */
+template <typename DECODER_T>
+static double interrupt_cost_ns()
+{
+  /* Pins are at the generator's state before the encoder reads its initial state */
+  quadrature_generator_c generator(1);
+  pins_write(generator.get_state());
+  DECODER_T              encoder(HARNESS_CH_A_PIN, HARNESS_CH_B_PIN);
+
+  const auto start = std::chrono::steady_clock::now();
+  for(size_t i = 0; i < HARNESS_COST_EDGES; i++)
+  {
+    pins_write(generator.step());
+    encoder.sample_channels();
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  if(encoder.get_count() != generator.get_expected_count())
+  {
+    printf("interrupt cost run decoded %d of %d edges\n", encoder.get_count(), generator.get_expected_count());
+  }
+
+  return (std::chrono::duration<double, std::nano>(end - start).count() / HARNESS_COST_EDGES);
+}
+
+/* Host time (ns) to decode one sample of a polled random walk, checked against the walk's net count */
+template <typename DECODER_T>
+static double walk_cost_ns(const std::vector<encoder_channel_state_t> &walk, encoder_count_t expected_count)
+{
+  pins_write(walk[0]);
+  DECODER_T decoder(HARNESS_CH_A_PIN, HARNESS_CH_B_PIN);
+
+  const auto start = std::chrono::steady_clock::now();
+  for(encoder_channel_state_t state : walk)
+  {
+    decoder.sample_state(state);
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  if((decoder.get_count() != expected_count) || decoder.get_skipped_count())
+  {
+    printf("random walk decoded %d of %d, %d skipped\n", decoder.get_count(), expected_count, decoder.get_skipped_count());
+  }
+
+  return (std::chrono::duration<double, std::nano>(end - start).count() / walk.size());
+}
+
+static void report_decoders()
+{
+  /* Quadrature order, a step forward is one index on */
+  static const encoder_channel_state_t states[] = {0b00, 0b10, 0b11, 0b01};
+
+  std::mt19937                         random(3);
+  std::vector<encoder_channel_state_t> walk(HARNESS_WALK_SAMPLES);
+  encoder_count_t                      expected_count = 0;
+  unsigned int                         position       = 0;
+  for(encoder_channel_state_t &state : walk)
+  {
+    /* Forward, backward or unchanged (twice as likely) */
+    switch(random() % 4)
+    {
+      case 0: expected_count++; position = ((position + 1) % 4); break;
+      case 1: expected_count--; position = ((position + 3) % 4); break;
+      default: break;
+    }
+    state = states[position];
+  }
+
+  const double table_edge_ns  = interrupt_cost_ns<encoder_c>();
+  const double switch_edge_ns = interrupt_cost_ns<baseline_decoder_c>();
+  const double table_walk_ns  = walk_cost_ns<encoder_c>(walk, expected_count);
+  const double switch_walk_ns = walk_cost_ns<baseline_decoder_c>(walk, expected_count);
+  printf("decoder          edges/s  random walk samples/s\n");
+  printf("  lookup table %10.0f %12.0f\n", (1e9 / table_edge_ns),  (1e9 / table_walk_ns));
+  printf("  switch       %10.0f %12.0f\n", (1e9 / switch_edge_ns), (1e9 / switch_walk_ns));
+  printf("  table/switch %9.2fx %11.2fx\n\n", (switch_edge_ns / table_edge_ns), (switch_walk_ns / table_walk_ns));
+}
+
+static harness_result_s run(const harness_config_s &config, int32_t edge_rate, float drop_probability, size_t edges = HARNESS_EDGES)
+{
+  quadrature_generator_c generator(edge_rate, config.jitter, drop_probability, 7);
+  const time_ns_t        end_time = (time_ns_t) ((1000000000.0 * edges) / edge_rate);
+  pins_write(generator.get_state());
+  encoder_c              encoder(HARNESS_CH_A_PIN, HARNESS_CH_B_PIN);
+
+  if(SCHEME_EDGE_INTERRUPT == config.scheme)
+  {
+    time_ns_t busy_until = 0;
+    while(generator.get_time() < end_time)
+    {
+      /* Next edge raises the interrupt, which starts once the previous one returns.
+          Edges before it starts are coalesced into it */
+      generator.step();
+      const time_ns_t start = (generator.get_time() > busy_until) ? generator.get_time() : busy_until;
+      pins_write(generator.advance(start));
+      encoder.sample_channels();
+      busy_until = (start + config.isr_ns);
+    }
+  }
+  else
+  {
+    for(uint64_t sample = 1; generator.get_time() < end_time; sample++)
+    {
+      pins_write(generator.advance((sample * 1000000000ULL) / config.sample_hz));
+      encoder.sample_channels();
+    }
+  }
+
+  harness_result_s result;
+  result.expected_count = generator.get_expected_count();
+  result.count          = encoder.get_count();
+  result.skipped_count  = encoder.get_skipped_count();
+  result.dropped_count  = generator.get_dropped_count();
+  return result;
+}
+
+static bool run_sustained(const harness_config_s &config, int32_t edge_rate)
+{
+  const harness_result_s result = run(config, edge_rate, 0.0f);
+  return ((result.count == result.expected_count) && (0 == result.skipped_count));
+}
+
+static void report(const char *name, const harness_config_s &config, double nominal_rate, encoder_count_t counts_per_revolution,
+                   float drop_probability)
+{
+  printf("\n%s\n", name);
+  printf("  edges/s       expected    decoded    error %%   skipped\n");
+  for(double ratio : {0.25, 0.5, 0.75, 0.9, 1.0, 1.25, 1.5, 2.0, 3.0})
+  {
+    const int32_t          edge_rate = (int32_t) (nominal_rate * ratio);
+    const harness_result_s result    = run(config, edge_rate, 0.0f);
+    printf("  %10d %10d %10d %9.3f %9d\n", edge_rate, result.expected_count, result.count,
+           (100.0 * (result.expected_count - result.count)) / result.expected_count, result.skipped_count);
+  }
+
+  /* Rate where edges start to be skipped, by bisection */
+  int32_t sustained = 0;
+  int32_t failed    = (int32_t) (nominal_rate * 4.0);
+  while((failed - sustained) > (failed / 1000))
+  {
+    const int32_t edge_rate = (sustained + ((failed - sustained) / 2));
+    if(run_sustained(config, edge_rate))
+    {
+      sustained = edge_rate;
+    }
+    else
+    {
+      failed = edge_rate;
+    }
+  }
+  printf("  max sustainable edge rate %d edges/s, %.0f RPM at %d counts per revolution\n", sustained,
+         ((60.0 * sustained) / counts_per_revolution), counts_per_revolution);
+
+  const harness_result_s dropped = run(config, (sustained / 2), drop_probability);
+  printf("  dropped edges at %d edges/s: %d dropped, %d skipped, decoded %d of %d (short %d)\n", (sustained / 2),
+         dropped.dropped_count, dropped.skipped_count, dropped.count, dropped.expected_count,
+         (dropped.expected_count - dropped.count));
+}
+
+int main(int argc, char **argv)
+{
+  const double          isr_ns_arg            = (argc > 1) ? strtod(argv[1], nullptr)                    : 0.0;
+  const uint32_t        sample_hz             = (argc > 2) ? strtoul(argv[2], nullptr, 0)                : 100000;
+  const float           jitter                = (argc > 3) ? strtof(argv[3], nullptr)                    : 0.2f;
+  const float           drop_probability      = (argc > 4) ? strtof(argv[4], nullptr)                    : 0.001f;
+  const encoder_count_t counts_per_revolution = (argc > 5) ? (encoder_count_t) strtol(argv[5], nullptr, 0) : 12;
+
+  if((0 == sample_hz) || (counts_per_revolution <= 0))
+  {
+    fprintf(stderr, "sample_hz and counts_per_revolution must be positive\n");
+    return 1;
+  }
+
+  clock_init();
+  /* Sampling runs as the pin interrupt would */
+  host_interrupt_context(true);
+
+  report_decoders();
+
+  const double cost_ns = interrupt_cost_ns<encoder_c>();
+  const double isr_ns  = (isr_ns_arg > 0.0) ? isr_ns_arg : cost_ns;
+  printf("host interrupt cost %.2f ns/edge (%.0f edges/s), simulating isr_ns %.2f, jitter %.2f\n", cost_ns, (1e9 / cost_ns),
+         isr_ns, jitter);
+
+  harness_config_s config;
+  config.isr_ns    = (time_ns_t) ((isr_ns < 1.0) ? 1.0 : isr_ns);
+  config.sample_hz = sample_hz;
+  config.jitter    = jitter;
+
+  config.scheme = SCHEME_EDGE_INTERRUPT;
+  report("edge interrupt", config, (1e9 / config.isr_ns), counts_per_revolution, drop_probability);
+
+  config.scheme = SCHEME_POLLED;
+  char name[64];
+  snprintf(name, sizeof(name), "polled at %u Hz", sample_hz);
+  report(name, config, sample_hz, counts_per_revolution, drop_probability);
+
+  host_interrupt_context(false);
+
+  return 0;
+}
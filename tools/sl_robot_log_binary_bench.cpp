@@ -0,0 +1,103 @@
+/*
+  sl_robot_log_binary_bench.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host benchmark of per-call logging cost with text (LOG_SNPRINTF) against deferred-formatting binary (LOG_BINARY) entries,
+    built against the host stand-ins in tools/host.
+  Logs the control loop's DEBUG_3 line, "|%+05d|%+05d|%+05d|" with three arguments, from one task in batches of
+    BENCH_BATCH_ENTRIES, flushing to a null text sink between batches so the task log buffer never fills.  Reported per mode:
+    call ns/entry   Host time of the logging call, the cost paid in the control loop
+    flush ns/entry  Host time of log_flush() per entry, where binary entries are formatted on the log task
+  A run logging nothing (level disabled at runtime) gives the cost of the level check alone.
+
+  Build: g++ -std=gnu++17 -O2 -D__IMXRT1062__ -Ihost -I../src sl_robot_log_binary_bench.cpp host/sl_robot_host.cpp
+           ../src/sl_robot_clock.cpp ../src/sl_robot_utils.cpp ../src/sl_robot_circular_buffer_record.cpp ../src/sl_robot_log.cpp
+           ../src/sl_robot_log_sink.cpp -lpthread -o sl_robot_log_binary_bench
+  Usage: sl_robot_log_binary_bench [entries]
+    entries  Entries logged per mode, default 1000000
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "sl_robot_log.hpp"
+#include "sl_robot_log_task.hpp"
+
+using namespace sandor_laboratories::robot;
+
+typedef std::chrono::steady_clock bench_clock_t;
+
+/* Entries logged between flushes, well within a task log buffer */
+#define BENCH_BATCH_ENTRIES 8
+
+typedef enum
+{
+  BENCH_MODE_DISABLED,
+  BENCH_MODE_SNPRINTF,
+  BENCH_MODE_BINARY,
+} bench_mode_e;
+
+static TaskHandle_t log_task_handle;
+
+static void run(const char *name, bench_mode_e mode, size_t entries)
+{
+  double            call_ns  = 0.0;
+  double            flush_ns = 0.0;
+  log_drop_counts_s drops_start;
+  log_drop_counts_s drops_end;
+
+  change_log_level(LOG_KEY_MOTOR_CONTROL_LOOP, (BENCH_MODE_DISABLED == mode) ? LOG_LEVEL_INFO : LOG_LEVEL_ALL);
+  log_get_drop_counts(&drops_start);
+  for(size_t i = 0; i < entries; i += BENCH_BATCH_ENTRIES)
+  {
+    /* Arguments vary as a control loop's would */
+    const int  error  = (int) (i & 0x3FF) - 512;
+    const auto start  = bench_clock_t::now();
+    for(int j = 0; j < BENCH_BATCH_ENTRIES; j++)
+    {
+      if(BENCH_MODE_BINARY == mode)
+      {
+        LOG_BINARY(LOG_KEY_MOTOR_CONTROL_LOOP, LOG_LEVEL_DEBUG_3, "|%+05d|%+05d|%+05d|", error, (error + j), (error * 2));
+      }
+      else
+      {
+        LOG_SNPRINTF(LOG_KEY_MOTOR_CONTROL_LOOP, LOG_LEVEL_DEBUG_3, "|%+05d|%+05d|%+05d|", error, (error + j), (error * 2));
+      }
+    }
+    const auto calls_end = bench_clock_t::now();
+    log_flush();
+    const auto flush_end = bench_clock_t::now();
+
+    call_ns  += std::chrono::duration<double, std::nano>(calls_end - start).count();
+    flush_ns += std::chrono::duration<double, std::nano>(flush_end - calls_end).count();
+  }
+  log_get_drop_counts(&drops_end);
+
+  printf("%-16s %14.1f %15.1f %8llu\n", name, (call_ns / entries), (flush_ns / entries),
+         (unsigned long long) (drops_end.full - drops_start.full));
+}
+
+int main(int argc, char **argv)
+{
+  const size_t entries = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 1000000;
+
+  if(0 == entries)
+  {
+    fprintf(stderr, "entries must be non-zero\n");
+    return 1;
+  }
+
+  log_init(&log_task_handle, LOG_LEVEL_INFO);
+  log_sink_null_c sink(LOG_SINK_FORMAT_TEXT);
+  log_set_sink(&sink);
+
+  printf("%-16s %14s %15s %8s\n", "mode", "call ns/entry", "flush ns/entry", "dropped");
+  run("disabled",     BENCH_MODE_DISABLED, entries);
+  run("LOG_SNPRINTF", BENCH_MODE_SNPRINTF, entries);
+  run("LOG_BINARY",   BENCH_MODE_BINARY,   entries);
+
+  return 0;
+}
@@ -0,0 +1,280 @@
+/*
+  sl_robot_log_decode.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host tool decoding binary log files written by log_sink_binary_file_c.
+  Seeks by time with a binary search over block headers and skips blocks without the requested key,
+    so only matching blocks are read.  Blocks are only approximately time ordered, so one block either side of
+    the time range is also read.
+
+  Build: g++ -std=c++17 -O2 -I../src sl_robot_log_decode.cpp -o sl_robot_log_decode
+  Usage: sl_robot_log_decode [-f from_us] [-t to_us] [-k key] [-i] file
+    -f, -t  Only decode entries from/to time in microseconds (inclusive)
+    -k      Only decode entries with log key (may be repeated)
+    -i      Print block index instead of entries
+*/
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "sl_robot_log.hpp"
+#include "sl_robot_log_file.hpp"
+
+using namespace sandor_laboratories::robot;
+
+typedef struct
+{
+  log_file_time_t from_time;
+  log_file_time_t to_time;
+  uint32_t        key_mask;
+  bool            index_only;
+} decode_options_s;
+
+/* Format strings defined in the current block */
+#define DECODE_FORMATS 256
+typedef struct
+{
+  uint32_t id;
+  char     format[SL_ROBOT_LOG_FILE_RECORD_BODY_MAX+1];
+} decode_format_s;
+
+static bool read_block(FILE *file, uint32_t block_size, uint32_t block_index, uint8_t *block)
+{
+  /* First block holds the file header */
+  return ((0 == fseek(file, ((long) block_size * (block_index+1)), SEEK_SET)) &&
+          (1 == fread(block, block_size, 1, file)));
+}
+static bool read_block_header(FILE *file, uint32_t block_size, uint32_t block_index, log_file_block_header_s *header)
+{
+  return ((0 == fseek(file, ((long) block_size * (block_index+1)), SEEK_SET)) &&
+          (1 == fread(header, sizeof(*header), 1, file)) &&
+          (SL_ROBOT_LOG_FILE_BLOCK_MAGIC == header->magic));
+}
+
+/* Returns 'true' if format only has integer conversions, which are safe to pass 32-bit arguments */
+static bool format_is_safe(const char *format)
+{
+  bool safe = true;
+
+  for(const char *c = format; safe && *c; c++)
+  {
+    if('%' == *c)
+    {
+      c++;
+      while(*c && strchr("-+ #0123456789.", *c))
+      {
+        c++;
+      }
+      safe = (('\0' != *c) && (nullptr != strchr("diouxXc%", *c)));
+    }
+  }
+
+  return safe;
+}
+
+static void decode_block(const uint8_t *block, const decode_options_s *options)
+{
+  static decode_format_s formats[DECODE_FORMATS];
+  size_t                 format_count = 0;
+
+  log_file_block_header_s header;
+  memcpy(&header, block, sizeof(header));
+
+  size_t offset = sizeof(header);
+  while((offset + sizeof(log_file_record_header_s)) <= header.used_length)
+  {
+    log_file_record_header_s record;
+    memcpy(&record, &block[offset], sizeof(record));
+    if((LOG_FILE_RECORD_END == record.type) || (record.length < sizeof(record)) || ((offset + record.length) > header.used_length))
+    {
+      break;
+    }
+
+    const uint8_t * const body        = &block[offset + sizeof(record)];
+    const size_t          body_length = (record.length - sizeof(record));
+    const log_file_time_t record_time = header.time + (int64_t) record.time_offset;
+    offset += record.length;
+
+    if(LOG_FILE_RECORD_FORMAT == record.type)
+    {
+      if(format_count < DECODE_FORMATS)
+      {
+        formats[format_count].id = (uint32_t) record.time_offset;
+        memcpy(formats[format_count].format, body, body_length);
+        formats[format_count].format[body_length] = '\0';
+        format_count++;
+      }
+      continue;
+    }
+    if((record_time < options->from_time) || (record_time > options->to_time) ||
+       ((record.key < 32) && !(options->key_mask & (1UL << record.key))))
+    {
+      continue;
+    }
+
+    printf("[0x%02x|0x%01x|%" PRIu64 "] ", record.key, record.level, record_time);
+    if(LOG_FILE_RECORD_TEXT == record.type)
+    {
+      printf("%.*s\n", (int) body_length, (const char *) body);
+    }
+    else if((LOG_FILE_RECORD_BINARY == record.type) && (body_length >= sizeof(uint32_t)))
+    {
+      uint32_t format_id;
+      uint32_t args[SL_ROBOT_LOG_BINARY_MAX_ARGS] = {0};
+      size_t   arg_count = ((body_length - sizeof(format_id)) / sizeof(uint32_t));
+      arg_count = (arg_count < SL_ROBOT_LOG_BINARY_MAX_ARGS) ? arg_count : SL_ROBOT_LOG_BINARY_MAX_ARGS;
+      memcpy(&format_id, body, sizeof(format_id));
+      memcpy(args, &body[sizeof(format_id)], (arg_count * sizeof(uint32_t)));
+
+      const char *format = nullptr;
+      for(size_t i = 0; (i < format_count) && !format; i++)
+      {
+        format = (formats[i].id == format_id) ? formats[i].format : nullptr;
+      }
+
+      static_assert(8 == SL_ROBOT_LOG_BINARY_MAX_ARGS, "binary log decoding expects 8 arguments");
+      if(format && format_is_safe(format))
+      {
+        printf(format, args[0], args[1], args[2], args[3], args[4], args[5], args[6], args[7]);
+        printf("\n");
+      }
+      else
+      {
+        printf("<format 0x%08" PRIx32 ">", format_id);
+        for(size_t i = 0; i < arg_count; i++)
+        {
+          printf(" 0x%08" PRIx32, args[i]);
+        }
+        printf("\n");
+      }
+    }
+    else
+    {
+      printf("<unknown record type %u>\n", record.type);
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  decode_options_s options = {0, UINT64_MAX, 0, false};
+  const char      *path    = nullptr;
+
+  for(int i = 1; i < argc; i++)
+  {
+    if((0 == strcmp(argv[i], "-f")) && ((i+1) < argc))
+    {
+      options.from_time = strtoull(argv[++i], nullptr, 0);
+    }
+    else if((0 == strcmp(argv[i], "-t")) && ((i+1) < argc))
+    {
+      options.to_time = strtoull(argv[++i], nullptr, 0);
+    }
+    else if((0 == strcmp(argv[i], "-k")) && ((i+1) < argc))
+    {
+      options.key_mask |= (1UL << (strtoul(argv[++i], nullptr, 0) & 0x1F));
+    }
+    else if(0 == strcmp(argv[i], "-i"))
+    {
+      options.index_only = true;
+    }
+    else
+    {
+      path = argv[i];
+    }
+  }
+  if(0 == options.key_mask)
+  {
+    options.key_mask = UINT32_MAX;
+  }
+  if(nullptr == path)
+  {
+    fprintf(stderr, "Usage: %s [-f from_us] [-t to_us] [-k key] [-i] file\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  FILE *file = fopen(path, "rb");
+  if(nullptr == file)
+  {
+    perror(path);
+    return EXIT_FAILURE;
+  }
+
+  log_file_header_s file_header;
+  if((1 != fread(&file_header, sizeof(file_header), 1, file)) ||
+     (SL_ROBOT_LOG_FILE_MAGIC != file_header.magic) ||
+     (SL_ROBOT_LOG_FILE_VERSION != file_header.version) ||
+     (file_header.block_size < sizeof(log_file_block_header_s)))
+  {
+    fprintf(stderr, "%s: not a version %u log file\n", path, SL_ROBOT_LOG_FILE_VERSION);
+    fclose(file);
+    return EXIT_FAILURE;
+  }
+
+  fseek(file, 0, SEEK_END);
+  const long     file_size   = ftell(file);
+  const uint32_t block_size  = file_header.block_size;
+  const uint32_t block_count = (file_size > (long) block_size) ? (uint32_t) ((file_size / block_size) - 1) : 0;
+
+  /* Binary search for the first block that may contain from_time.  Blocks are written in flush order, which is only
+      approximately time order: an entry committed after a later entry was flushed lands in the next block, so adjacent
+      block times may overlap.  One neighbouring block is scanned on each side of the range found, decode_block() drops
+      entries outside it */
+  uint32_t first = 0, last = block_count;
+  while(first < last)
+  {
+    const uint32_t          middle = first + ((last - first) / 2);
+    log_file_block_header_s header;
+    if(read_block_header(file, block_size, middle, &header) && ((header.time + header.duration) < options.from_time))
+    {
+      first = middle + 1;
+    }
+    else
+    {
+      last = middle;
+    }
+  }
+  first = (first > 0) ? (first - 1) : 0;
+
+  uint8_t *block     = (uint8_t *) malloc(block_size);
+  bool     after_end = false;
+  for(uint32_t block_index = first; block_index < block_count; block_index++)
+  {
+    log_file_block_header_s header;
+    if(!read_block_header(file, block_size, block_index, &header))
+    {
+      fprintf(stderr, "%s: invalid block %" PRIu32 "\n", path, block_index);
+      continue;
+    }
+    if(header.time > options.to_time)
+    {
+      if(after_end)
+      {
+        break;
+      }
+      after_end = true;
+    }
+    if(0 == (header.key_mask & options.key_mask))
+    {
+      continue;
+    }
+
+    if(options.index_only)
+    {
+      printf("block %" PRIu32 " time %" PRIu64 "-%" PRIu64 " keys 0x%08" PRIx32 " records %u bytes %u\n",
+        header.sequence, header.time, (header.time + header.duration), header.key_mask, header.record_count, header.used_length);
+    }
+    else if(read_block(file, block_size, block_index, block))
+    {
+      decode_block(block, &options);
+    }
+  }
+
+  free(block);
+  fclose(file);
+  return EXIT_SUCCESS;
+}
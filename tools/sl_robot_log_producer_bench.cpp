@@ -0,0 +1,136 @@
+/*
+  sl_robot_log_producer_bench.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host benchmark of logging throughput for 1 to 16 producer tasks, built against the host stand-ins in tools/host.
+  Producer threads log binary entries (allocate, fill and commit, as log_binary() does) while a log task thread runs
+    log_flush() on each notification into a null binary sink.  A producer retries, yielding, when its buffer is full,
+    so every entry is delivered and the rate reported is what the logger sustains.
+  The first LOG_TASK_BUFFERS_MAX (8) producers claim their own task log buffer, later producers share the multi-producer
+    log buffer with interrupts, so scaling past 8 shows the cost of contended allocation.  Reported per producer count:
+    entries/s       Aggregate entries delivered per second
+    ns/entry        Host time per delivered entry per producer, retries included
+    full/entry      Allocations that found the buffer full, per delivered entry
+  Producer threads share the host CPUs with the log task, so figures on a single CPU host show contention, not parallel speedup.
+
+  Build: g++ -std=gnu++17 -O2 -D__IMXRT1062__ -Ihost -I../src sl_robot_log_producer_bench.cpp host/sl_robot_host.cpp
+           ../src/sl_robot_clock.cpp ../src/sl_robot_utils.cpp ../src/sl_robot_circular_buffer_record.cpp ../src/sl_robot_log.cpp
+           ../src/sl_robot_log_sink.cpp -lpthread -o sl_robot_log_producer_bench
+  Usage: sl_robot_log_producer_bench [entries] [producers_max]
+    entries        Entries logged per producer, default 100000
+    producers_max  Largest producer count, default 16
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "sl_robot_log.hpp"
+#include "sl_robot_log_task.hpp"
+#include "sl_robot_utils.hpp"
+
+using namespace sandor_laboratories::robot;
+
+#define BENCH_PRODUCERS_MAX 16
+/* Wait for a notification between flushes (ms), bounds the time a producer waits on a missed notification */
+#define BENCH_FLUSH_WAIT_MS 1
+
+static TaskHandle_t           log_task_handle;
+static std::atomic<bool>      running;
+static std::atomic<uint64_t>  full_count;
+
+static void log_task()
+{
+  log_task_handle = xTaskGetCurrentTaskHandle();
+  while(running.load(std::memory_order_relaxed))
+  {
+    task_notify_wait(BENCH_FLUSH_WAIT_MS);
+    log_flush();
+  }
+  log_flush();
+}
+
+static void producer(size_t entries, uint32_t producer_index)
+{
+  static const char * const format = "producer %u entry %u";
+  constexpr size_t payload_length  = offsetof(log_binary_payload_s, args) + (2 * sizeof(log_binary_arg_t));
+
+  uint64_t full = 0;
+  for(uint32_t i = 0; i < entries; )
+  {
+    log_entry_s * log_entry = log_entry_allocate(LOG_KEY_DEBUG_TASK, LOG_LEVEL_INFO, payload_length);
+    if(log_entry)
+    {
+      const log_binary_payload_s payload = {format, 2, {producer_index, i}};
+      memcpy(log_entry->payload, &payload, payload_length);
+      log_entry->hdr.format = LOG_FORMAT_BINARY;
+      log_entry_commit(log_entry);
+      i++;
+    }
+    else
+    {
+      full++;
+      std::this_thread::yield();
+    }
+  }
+  full_count.fetch_add(full, std::memory_order_relaxed);
+  log_task_unregister();
+}
+
+int main(int argc, char **argv)
+{
+  const size_t   entries       = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 100000;
+  const uint32_t producers_max = (argc > 2) ? strtoul(argv[2], nullptr, 0) : BENCH_PRODUCERS_MAX;
+
+  if((0 == entries) || (0 == producers_max) || (producers_max > BENCH_PRODUCERS_MAX))
+  {
+    fprintf(stderr, "entries must be non-zero and producers_max 1 to %d\n", BENCH_PRODUCERS_MAX);
+    return 1;
+  }
+
+  log_init(&log_task_handle, LOG_LEVEL_INFO);
+  log_sink_null_c sink(LOG_SINK_FORMAT_BINARY);
+  log_set_sink(&sink);
+
+  printf("producers  entries/s   ns/entry  full/entry  delivered\n");
+  for(uint32_t producers = 1; producers <= producers_max; producers++)
+  {
+    running.store(true);
+    full_count.store(0);
+    const size_t discarded_start = sink.records();
+    std::thread  log_thread(log_task);
+    while(nullptr == log_task_handle)
+    {
+      std::this_thread::yield();
+    }
+
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < producers; i++)
+    {
+      threads.emplace_back(producer, entries, i);
+    }
+    for(auto &thread : threads)
+    {
+      thread.join();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    running.store(false);
+    log_thread.join();
+    log_task_handle = nullptr;
+
+    const double   seconds   = std::chrono::duration<double>(end - start).count();
+    const uint64_t total     = ((uint64_t) entries * producers);
+    const size_t   delivered = (sink.records() - discarded_start);
+    printf("%9u %10.0f %10.1f %11.3f %10zu%s\n", producers, (total / seconds), ((seconds * 1e9 * producers) / total),
+           ((double) full_count.load() / total), delivered, (delivered < total) ? "  FAIL" : "");
+  }
+
+  return 0;
+}
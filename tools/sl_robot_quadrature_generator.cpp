@@ -0,0 +1,98 @@
+/*
+  sl_robot_quadrature_generator.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+*/
+
+#include "sl_robot_quadrature_generator.hpp"
+
+using namespace sandor_laboratories::robot;
+
+/* Channel state of each phase, in forward order */
+static const encoder_channel_state_t quadrature_phases[4] = {0b00, 0b10, 0b11, 0b01};
+
+quadrature_generator_c::quadrature_generator_c(int32_t edges_per_second, float edge_jitter, float edge_drop_probability, uint32_t seed)
+  : edge_rate(edges_per_second), jitter(edge_jitter), drop_probability(edge_drop_probability), random_state(seed ? seed : 1),
+    phase(0), state(quadrature_phases[0]), time(0), expected_count(0), dropped_count(0)
+{
+  next_edge_time = edge_interval();
+}
+
+/* xorshift32, deterministic for a given seed */
+uint32_t quadrature_generator_c::random()
+{
+  random_state ^= (random_state << 13);
+  random_state ^= (random_state >> 17);
+  random_state ^= (random_state << 5);
+  return random_state;
+}
+/* Returns uniform random value in [0, 1) */
+float quadrature_generator_c::random_unit()
+{
+  return ((float) (random() >> 8) / (float) (1UL << 24));
+}
+
+/* Returns time to the next edge, 0 if stopped */
+time_ns_t quadrature_generator_c::edge_interval()
+{
+  time_ns_t ret_val = 0;
+
+  if(edge_rate)
+  {
+    const float nominal = (1000000000.0f / (float) ((edge_rate < 0) ? -edge_rate : edge_rate));
+    const float offset  = (jitter > 0.0f) ? (nominal * jitter * ((2.0f * random_unit()) - 1.0f)) : 0.0f;
+    ret_val = (time_ns_t) (nominal + offset);
+    ret_val = ret_val ? ret_val : 1;
+  }
+
+  return ret_val;
+}
+
+void quadrature_generator_c::edge()
+{
+  const int direction = (edge_rate < 0) ? -1 : 1;
+
+  phase           = ((phase + 4 + direction) % 4);
+  expected_count += direction;
+
+  /* Dropped edges stay hidden until the next visible edge */
+  if((drop_probability > 0.0f) && (random_unit() < drop_probability))
+  {
+    dropped_count++;
+  }
+  else
+  {
+    state = quadrature_phases[phase];
+  }
+}
+
+void quadrature_generator_c::set_edge_rate(int32_t edges_per_second)
+{
+  edge_rate      = edges_per_second;
+  next_edge_time = time + edge_interval();
+}
+
+encoder_channel_state_t quadrature_generator_c::advance(time_ns_t to_time)
+{
+  while(edge_rate && (next_edge_time <= to_time))
+  {
+    time = next_edge_time;
+    edge();
+    next_edge_time = time + edge_interval();
+  }
+  time = (to_time > time) ? to_time : time;
+
+  return state;
+}
+encoder_channel_state_t quadrature_generator_c::step()
+{
+  if(edge_rate)
+  {
+    time = next_edge_time;
+    edge();
+    next_edge_time = time + edge_interval();
+  }
+
+  return state;
+}
@@ -0,0 +1,75 @@
+/*
+  sl_robot_quadrature_generator.hpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host-side quadrature waveform generator, used by the encoder harness (sl_robot_encoder_harness.cpp).
+*/
+
+#ifndef __SL_ROBOT_QUADRATURE_GENERATOR_HPP__
+#define __SL_ROBOT_QUADRATURE_GENERATOR_HPP__
+
+#include <cstdint>
+
+#include "sl_robot_encoder.hpp"
+#include "sl_robot_types.hpp"
+
+namespace sandor_laboratories
+{
+  namespace robot
+  {
+    /* Simulated time type (ns) */
+    typedef uint64_t time_ns_t;
+
+    /* Generates a simulated quadrature waveform, for exercising encoder_c and encoder_bank_c without hardware.
+        Edges follow the encoder state order 0b00->0b10->0b11->0b01->0b00 (forward for positive edge rates).
+        Edge intervals may be jittered, and edges may be dropped - a dropped edge is not visible until the next edge,
+          so the decoder sees both channels change at once (a skipped edge).
+        Time is simulated in nanoseconds, independent of the clock. */
+    class quadrature_generator_c
+    {
+      private:
+        /* Edges per second, negative is reverse */
+        int32_t                 edge_rate;
+        /* Interval jitter as a fraction of the nominal edge interval, 0 to 1 */
+        float                   jitter;
+        /* Probability of each edge being dropped, 0 to 1 */
+        float                   drop_probability;
+        uint32_t                random_state;
+
+        /* Generated and visible states */
+        unsigned int            phase;
+        encoder_channel_state_t state;
+        time_ns_t               time;
+        time_ns_t               next_edge_time;
+
+        /* Net generated edges (forward positive) and edges dropped */
+        encoder_count_t         expected_count;
+        encoder_count_t         dropped_count;
+
+        uint32_t                random();
+        float                   random_unit();
+        time_ns_t               edge_interval();
+        void                    edge();
+
+      public:
+        quadrature_generator_c(int32_t edges_per_second, float edge_jitter = 0.0f, float edge_drop_probability = 0.0f, uint32_t seed = 1);
+
+        /* Changes edge rate from the next edge */
+        void                    set_edge_rate(int32_t edges_per_second);
+
+        /* Generates edges up to simulated time (ns), returns the visible channel state at that time */
+        encoder_channel_state_t advance(time_ns_t to_time);
+        /* Generates the next edge immediately, as seen by an edge interrupt.  Returns the visible channel state */
+        encoder_channel_state_t step();
+
+        inline encoder_channel_state_t get_state()          const {return state;}
+        inline time_ns_t               get_time()           const {return time;}
+        inline encoder_count_t         get_expected_count() const {return expected_count;}
+        inline encoder_count_t         get_dropped_count()  const {return dropped_count;}
+    };
+  }
+}
+
+#endif // __SL_ROBOT_QUADRATURE_GENERATOR_HPP__
@@ -0,0 +1,115 @@
+/*
+  sl_robot_velocity_estimator_bench.cpp
+  Sandor Laboratories Combat Robot Software
+  Edward Sandor
+  October 2026
+
+  Host benchmark for the velocity estimators, built against the host stand-ins in tools/host.
+  Each estimator is fed a constant acceleration ramp with gaussian measurement noise, as encoder_c::loop() would feed it
+    (fixed point RPM through the velocity_estimator_c interface).  Reported per estimator:
+    ns/update  Host time per update() call.  Ratios between estimators carry over to the target better than absolute
+                times, the alpha-beta and Kalman estimators use single precision float (hardware on the Cortex-M7)
+    rpm rms    RPM error against the true ramp once settled
+    accel rms  Acceleration error (RPM/s) against the true ramp once settled
+
+  Build: g++ -std=gnu++17 -O2 -D__IMXRT1062__ -Ihost -I../src sl_robot_velocity_estimator_bench.cpp host/sl_robot_host.cpp
+           ../src/sl_robot_utils.cpp ../src/sl_robot_velocity_estimator.cpp -lpthread -o sl_robot_velocity_estimator_bench
+  Usage: sl_robot_velocity_estimator_bench [updates] [period_us] [noise_rpm]
+    updates    Updates per estimator, default 1000000
+    period_us  Time between updates (encoder loop() period), default 1000
+    noise_rpm  Standard deviation of measurement noise, default 20
+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "sl_robot_velocity_estimator.hpp"
+
+using namespace sandor_laboratories::robot;
+
+/* Ramp start and acceleration */
+#define BENCH_RPM_START    1000.0
+#define BENCH_ACCELERATION 2000.0
+/* Updates skipped before errors are accumulated, so estimators settle */
+#define BENCH_SETTLE_UPDATES 500
+
+int main(int argc, char **argv)
+{
+  const size_t    updates   = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 1000000;
+  const time_us_t period_us = (argc > 2) ? strtoul(argv[2], nullptr, 0) : 1000;
+  const double    noise_rpm = (argc > 3) ? strtod(argv[3], nullptr)     : 20.0;
+
+  if((updates <= BENCH_SETTLE_UPDATES) || (0 == period_us))
+  {
+    fprintf(stderr, "updates must exceed %d and period_us must be non-zero\n", BENCH_SETTLE_UPDATES);
+    return 1;
+  }
+
+  velocity_estimator_moving_average_c moving_average(8);
+  velocity_estimator_alpha_beta_c     alpha_beta(0.3f, 0.02f);
+  velocity_estimator_kalman_c         kalman(1e7f, (float) (noise_rpm * noise_rpm));
+
+  struct
+  {
+    const char           *name;
+    velocity_estimator_c *estimator;
+  } const estimators[] =
+  {
+    {"moving average (8)",      &moving_average},
+    {"alpha-beta (0.3, 0.02)",  &alpha_beta},
+    {"kalman",                  &kalman},
+  };
+
+  /* Measurements are generated up front so only update() is timed.
+      The ramp wraps back to its start every second, so long runs stay in range */
+  const size_t             ramp_updates = ((1000000 / period_us) > BENCH_SETTLE_UPDATES) ? (1000000 / period_us) : updates;
+  std::vector<rpm_fixed_t> measurements(updates);
+  std::vector<double>      true_rpms(updates);
+  std::mt19937             generator(1);
+  std::normal_distribution<double> noise(0.0, noise_rpm);
+  for(size_t i = 0; i < updates; i++)
+  {
+    const double t = (((double) (i % ramp_updates) * period_us) / 1000000.0);
+    true_rpms[i]    = (BENCH_RPM_START + (BENCH_ACCELERATION * t));
+    measurements[i] = (rpm_fixed_t) lround((true_rpms[i] + noise(generator)) * (1 << RPM_FIXED_FRACTION_BITS));
+  }
+
+  printf("estimator                ns/update  rpm rms  accel rms\n");
+  for(const auto &entry : estimators)
+  {
+    velocity_estimator_c * const estimator = entry.estimator;
+
+    estimator->reset();
+    const auto start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < updates; i++)
+    {
+      estimator->update(measurements[i], period_us);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    /* Accuracy on the first ramp, with the outputs a caller would read after each update */
+    const size_t ramp_end      = (ramp_updates < updates) ? ramp_updates : updates;
+    double       rpm_error     = 0.0;
+    double       accel_error   = 0.0;
+    estimator->reset();
+    for(size_t i = 0; i < ramp_end; i++)
+    {
+      estimator->update(measurements[i], period_us);
+      if(i >= BENCH_SETTLE_UPDATES)
+      {
+        rpm_error   += pow(estimator->get_rpm() - true_rpms[i], 2);
+        accel_error += pow(estimator->get_acceleration() - BENCH_ACCELERATION, 2);
+      }
+    }
+
+    printf("%-24s %9.1f %8.1f %10.0f\n", entry.name,
+           (std::chrono::duration<double, std::nano>(end - start).count() / updates),
+           sqrt(rpm_error / (ramp_end - BENCH_SETTLE_UPDATES)), sqrt(accel_error / (ramp_end - BENCH_SETTLE_UPDATES)));
+  }
+
+  return 0;
+}